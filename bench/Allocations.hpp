@@ -0,0 +1,13 @@
+#ifndef _ALLOCATIONS_HPP
+#define _ALLOCATIONS_HPP
+
+#include <cstdint>
+
+namespace bench {
+
+// Number of calls to the global operator new since the start of the process.
+std::uint64_t allocationCount() noexcept;
+
+} // namespace bench
+
+#endif
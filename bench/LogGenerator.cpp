@@ -0,0 +1,156 @@
+#include <LogGenerator.hpp>
+
+#include <deque>
+#include <sstream>
+#include <vector>
+
+namespace bench {
+
+namespace {
+
+enum class ClientState : std::uint8_t {
+  ABSENT,
+  PRESENT,
+  SEATED,
+  WAITING
+};
+
+void writeTime(std::ostream& out, int time)
+{
+  auto hour = time / 60;
+  auto minute = time % 60;
+
+  out << static_cast<char>('0' + hour / 10) << static_cast<char>('0' + hour % 10) << ':'
+      << static_cast<char>('0' + minute / 10) << static_cast<char>('0' + minute % 10);
+}
+
+} // namespace
+
+LogGenerator::LogGenerator(LogGeneratorOptions options) noexcept :
+    options(options),
+    state(options.seed * 0x9E3779B97F4A7C15ull + 1)
+{}
+
+std::uint64_t LogGenerator::random() noexcept
+{
+  // splitmix64, so the sequence does not depend on the standard library.
+  state += 0x9E3779B97F4A7C15ull;
+  auto value = state;
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+  return value ^ (value >> 31);
+}
+
+bool LogGenerator::chance(double probability) noexcept
+{
+  return static_cast<double>(random() >> 11) * 0x1.0p-53 < probability;
+}
+
+std::uint64_t LogGenerator::below(std::uint64_t bound) noexcept
+{
+  return random() % bound;
+}
+
+void LogGenerator::write(std::ostream& out)
+{
+  out << options.table_count << '\n';
+  writeTime(out, options.begin_time);
+  out << ' ';
+  writeTime(out, options.end_time);
+  out << '\n' << options.cost_per_hour << '\n';
+
+  std::vector<ClientState> clients(options.client_count, ClientState::ABSENT);
+  std::vector<std::uint32_t> seat(options.client_count, 0);
+  std::vector<std::uint32_t> free_tables;
+  std::deque<std::uint32_t> queue;
+  std::size_t waiting = 0;
+
+  for (std::uint32_t table = 0; table < options.table_count; ++table) {
+    free_tables.push_back(table);
+  }
+
+  auto open_time = static_cast<std::uint64_t>(options.end_time - options.begin_time);
+
+  for (std::uint64_t i = 0; i < options.event_count; ++i) {
+    auto time = options.begin_time + static_cast<int>(i * open_time / options.event_count);
+
+    writeTime(out, time);
+
+    if (chance(options.malformed_ratio)) {
+      out << " 2  client" << below(options.client_count) << " 1\n";
+      continue;
+    }
+
+    if (chance(options.error_ratio)) {
+      // An unknown client leaving: ClientUnknown.
+      out << " 4 ghost" << below(1000) << '\n';
+      continue;
+    }
+
+    auto client = static_cast<std::uint32_t>(below(options.client_count));
+
+    switch (clients[client]) {
+    case ClientState::ABSENT: {
+      out << " 1 client" << client << '\n';
+      clients[client] = ClientState::PRESENT;
+      break;
+    }
+    case ClientState::PRESENT: {
+      if (!free_tables.empty()) {
+        auto index = below(free_tables.size());
+        seat[client] = free_tables[index];
+        free_tables[index] = free_tables.back();
+        free_tables.pop_back();
+
+        out << " 2 client" << client << ' ' << seat[client] + 1 << '\n';
+        clients[client] = ClientState::SEATED;
+      } else if (waiting < options.table_count && chance(options.queue_pressure)) {
+        out << " 3 client" << client << '\n';
+        clients[client] = ClientState::WAITING;
+        queue.push_back(client);
+        ++waiting;
+      } else {
+        out << " 4 client" << client << '\n';
+        clients[client] = ClientState::ABSENT;
+      }
+      break;
+    }
+    case ClientState::SEATED: {
+      out << " 4 client" << client << '\n';
+      clients[client] = ClientState::ABSENT;
+
+      // The club seats the first waiting client at the table that got free.
+      while (!queue.empty() && clients[queue.front()] != ClientState::WAITING) {
+        queue.pop_front();
+      }
+
+      if (queue.empty()) {
+        free_tables.push_back(seat[client]);
+      } else {
+        seat[queue.front()] = seat[client];
+        clients[queue.front()] = ClientState::SEATED;
+        queue.pop_front();
+        --waiting;
+      }
+      break;
+    }
+    case ClientState::WAITING: {
+      out << " 4 client" << client << '\n';
+      clients[client] = ClientState::ABSENT;
+      --waiting;
+      break;
+    }
+    }
+  }
+}
+
+std::string LogGenerator::generate()
+{
+  std::ostringstream out;
+
+  write(out);
+
+  return std::move(out).str();
+}
+
+} // namespace bench
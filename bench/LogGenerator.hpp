@@ -0,0 +1,48 @@
+#ifndef _LOG_GENERATOR_HPP
+#define _LOG_GENERATOR_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace bench {
+
+struct LogGeneratorOptions {
+  std::uint32_t table_count{10};
+  std::uint32_t client_count{100};
+  std::uint64_t event_count{1000};
+  // Share of clients who queue up when no table is free instead of leaving.
+  double queue_pressure{0.5};
+  // Share of events the club answers with a generated error (ID 13).
+  double error_ratio{0.05};
+  // Share of lines that are not valid events. Processing stops at the first one,
+  // so this is meant for parser benchmarks.
+  double malformed_ratio{0.0};
+  int begin_time{9 * 60};
+  int end_time{21 * 60};
+  std::uint32_t cost_per_hour{10};
+  std::uint64_t seed{1};
+};
+
+// Produces the same club day log for the same options on every platform. The
+// events follow a model of the club, so apart from the requested errors they are
+// accepted by RevenuerManager.
+class LogGenerator {
+public:
+  explicit LogGenerator(LogGeneratorOptions options) noexcept;
+
+  void write(std::ostream& out);
+  std::string generate();
+
+private:
+  std::uint64_t random() noexcept;
+  bool chance(double probability) noexcept;
+  std::uint64_t below(std::uint64_t bound) noexcept;
+
+  LogGeneratorOptions options;
+  std::uint64_t state;
+};
+
+} // namespace bench
+
+#endif
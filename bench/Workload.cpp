@@ -0,0 +1,75 @@
+#include <Workload.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace bench {
+
+const std::string& cachedLog(const LogGeneratorOptions& options)
+{
+  using Key = std::tuple<
+      std::uint32_t, std::uint32_t, std::uint64_t, double, double, double, std::uint64_t>;
+
+  static std::mutex mutex;
+  static std::map<Key, std::string> logs;
+
+  std::lock_guard lock(mutex);
+
+  Key key(
+      options.table_count, options.client_count, options.event_count,
+      options.queue_pressure, options.error_ratio, options.malformed_ratio, options.seed
+  );
+  auto it = logs.find(key);
+
+  if (it == logs.end()) {
+    it = logs.emplace(key, LogGenerator(options).generate()).first;
+  }
+
+  return it->second;
+}
+
+std::vector<std::string_view> eventLines(const std::string& log)
+{
+  std::vector<std::string_view> lines;
+  std::string_view rest = log;
+
+  for (std::size_t skipped = 0; !rest.empty();) {
+    auto end = rest.find('\n');
+    auto line = rest.substr(0, end);
+
+    rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+
+    if (skipped < 3) {
+      ++skipped;
+      continue;
+    }
+    lines.push_back(line);
+  }
+
+  return lines;
+}
+
+std::int64_t maxEventCount() noexcept
+{
+  if (const char* value = std::getenv("TASK_BENCH_MAX_EVENTS")) {
+    return std::max(1000ll, std::atoll(value));
+  }
+  return 1'000'000;
+}
+
+void reportThroughput(
+    benchmark::State& state, std::uint64_t events, std::uint64_t bytes,
+    std::uint64_t allocations
+)
+{
+  state.SetItemsProcessed(static_cast<std::int64_t>(events));
+  state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+  state.counters["allocs_per_event"] = benchmark::Counter(
+      events == 0 ? 0.0 : static_cast<double>(allocations) / static_cast<double>(events)
+  );
+}
+
+} // namespace bench
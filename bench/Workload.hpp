@@ -0,0 +1,57 @@
+#ifndef _WORKLOAD_HPP
+#define _WORKLOAD_HPP
+
+#include <LogGenerator.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench {
+
+// Generated once per set of options and kept for the rest of the run.
+const std::string& cachedLog(const LogGeneratorOptions& options);
+
+// Lines of a log without the three header lines.
+std::vector<std::string_view> eventLines(const std::string& log);
+
+// Largest log size for the end-to-end benchmarks, TASK_BENCH_MAX_EVENTS or 1M.
+std::int64_t maxEventCount() noexcept;
+
+// Sets events/s, bytes/s and allocations per event on the benchmark.
+void reportThroughput(
+    benchmark::State& state, std::uint64_t events, std::uint64_t bytes,
+    std::uint64_t allocations
+);
+
+// Output stream that drops everything written to it.
+class NullStream : public std::ostream {
+  struct Buffer : std::streambuf {
+    std::streamsize xsputn(const char*, std::streamsize count) override
+    {
+      return count;
+    }
+
+    int_type overflow(int_type value) override
+    {
+      return traits_type::not_eof(value);
+    }
+  };
+
+public:
+  NullStream() :
+      std::ostream(&buffer)
+  {}
+
+private:
+  Buffer buffer;
+};
+
+} // namespace bench
+
+#endif
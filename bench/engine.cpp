@@ -0,0 +1,250 @@
+#include <Allocations.hpp>
+#include <Workload.hpp>
+
+#include <BinaryLog.hpp>
+#include <RevenuerManager.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <fcntl.h>
+#include <optional>
+#include <unistd.h>
+
+namespace {
+
+void runProcess(
+    benchmark::State& state, bench::LogGeneratorOptions options,
+    task::RevenuerManagerOptions manager_options = {}
+)
+{
+  const auto& log = bench::cachedLog(options);
+  bench::NullStream out;
+
+  auto allocations = bench::allocationCount();
+
+  for (auto _ : state) {
+    task::RevenuerManager manager(std::string_view(log), out, manager_options);
+
+    if (!manager.tryProcess()) {
+      state.SkipWithError("Generated log was rejected");
+      return;
+    }
+  }
+
+  bench::reportThroughput(
+      state, state.iterations() * options.event_count, state.iterations() * log.size(),
+      bench::allocationCount() - allocations
+  );
+}
+
+// Arguments: events.
+void BM_Process(benchmark::State& state)
+{
+  bench::LogGeneratorOptions options;
+  options.event_count = state.range(0);
+
+  runProcess(state, options);
+}
+BENCHMARK(BM_Process)
+    ->RangeMultiplier(10)
+    ->Range(1000, bench::maxEventCount())
+    ->Unit(benchmark::kMillisecond);
+
+void BM_ProcessStreaming(benchmark::State& state)
+{
+  bench::LogGeneratorOptions options;
+  options.event_count = state.range(0);
+
+  runProcess(state, options, task::RevenuerManagerOptions{.streaming = true});
+}
+BENCHMARK(BM_ProcessStreaming)
+    ->RangeMultiplier(10)
+    ->Range(1000, bench::maxEventCount())
+    ->Unit(benchmark::kMillisecond);
+
+// The stages run on their own threads, so wall-clock time is what counts.
+void BM_ProcessPipelined(benchmark::State& state)
+{
+  bench::LogGeneratorOptions options;
+  options.event_count = state.range(0);
+
+  runProcess(state, options, task::RevenuerManagerOptions{.pipelined = true});
+}
+BENCHMARK(BM_ProcessPipelined)
+    ->RangeMultiplier(10)
+    ->Range(1000, bench::maxEventCount())
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments: events, tables, clients.
+void BM_ProcessClubSize(benchmark::State& state)
+{
+  bench::LogGeneratorOptions options;
+  options.event_count = state.range(0);
+  options.table_count = state.range(1);
+  options.client_count = state.range(2);
+
+  runProcess(state, options);
+}
+BENCHMARK(BM_ProcessClubSize)
+    ->Args({100'000, 10, 100})
+    ->Args({100'000, 1'000, 10'000})
+    ->Args({100'000, 10'000, 100'000})
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments: events, queue pressure and error ratio in percent.
+void BM_ProcessLoad(benchmark::State& state)
+{
+  bench::LogGeneratorOptions options;
+  options.event_count = state.range(0);
+  options.queue_pressure = state.range(1) / 100.0;
+  options.error_ratio = state.range(2) / 100.0;
+  options.client_count = 1'000;
+
+  runProcess(state, options);
+}
+BENCHMARK(BM_ProcessLoad)
+    ->Args({100'000, 0, 0})
+    ->Args({100'000, 100, 0})
+    ->Args({100'000, 50, 30})
+    ->Unit(benchmark::kMillisecond);
+
+// The same logs as BM_Process, converted to the binary format beforehand.
+void BM_ProcessBinary(benchmark::State& state)
+{
+  bench::LogGeneratorOptions options;
+  options.event_count = state.range(0);
+
+  const auto& log = bench::cachedLog(options);
+  std::string binary;
+  std::string error_line;
+
+  if (!task::textToBinaryLog(log, binary, error_line)) {
+    state.SkipWithError("Generated log was rejected");
+    return;
+  }
+
+  bench::NullStream out;
+  auto allocations = bench::allocationCount();
+
+  for (auto _ : state) {
+    if (!task::processBinaryLog(binary, out, {}, error_line)) {
+      state.SkipWithError("Binary log was rejected");
+      return;
+    }
+  }
+
+  bench::reportThroughput(
+      state, state.iterations() * options.event_count, state.iterations() * binary.size(),
+      bench::allocationCount() - allocations
+  );
+  state.counters["text_to_binary_size"] =
+      benchmark::Counter(static_cast<double>(log.size()) / static_cast<double>(binary.size()));
+}
+BENCHMARK(BM_ProcessBinary)
+    ->RangeMultiplier(10)
+    ->Range(1000, bench::maxEventCount())
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments: events, output mode (0 buffered, 1 streaming, 2 streaming with 4 KiB
+// buffer, 3 line by line). The transcript goes to /dev/null through the
+// descriptor sink, writes are reported per million events.
+void BM_ProcessOutput(benchmark::State& state)
+{
+  bench::LogGeneratorOptions options;
+  options.event_count = state.range(0);
+
+  task::RevenuerManagerOptions manager_options;
+  manager_options.streaming = state.range(1) != 0;
+  manager_options.stream_buffer_size = state.range(1) == 2 ? 1 << 12 : 1 << 16;
+  manager_options.flush_each_line = state.range(1) == 3;
+
+  const auto& log = bench::cachedLog(options);
+  int fd = ::open("/dev/null", O_WRONLY);
+  std::uint64_t writes = 0;
+
+  auto allocations = bench::allocationCount();
+
+  for (auto _ : state) {
+    task::RevenuerManager manager(
+        std::string_view(log), task::OutputTarget::descriptor(fd), manager_options
+    );
+
+    if (!manager.tryProcess()) {
+      state.SkipWithError("Generated log was rejected");
+      break;
+    }
+    writes += manager.outputWriteCount();
+  }
+
+  ::close(fd);
+
+  auto events = state.iterations() * options.event_count;
+
+  bench::reportThroughput(
+      state, events, state.iterations() * log.size(), bench::allocationCount() - allocations
+  );
+  state.counters["writes_per_1M_events"] = benchmark::Counter(
+      events == 0 ? 0.0 : static_cast<double>(writes) * 1e6 / static_cast<double>(events)
+  );
+}
+BENCHMARK(BM_ProcessOutput)
+    ->ArgsProduct({{bench::maxEventCount()}, {0, 1, 2, 3}})
+    ->Unit(benchmark::kMillisecond);
+
+// Closing time with a full club: a third of the clients seated, a third waiting
+// and a third just arrived, only the end of the day is timed. Arguments: tables.
+void BM_Closing(benchmark::State& state)
+{
+  auto table_count = static_cast<std::uint32_t>(state.range(0));
+  task::RevenuerManagerData data{
+      .table_count = table_count, .begin_time = 9 * 60, .end_time = 21 * 60,
+      .cost_per_hour = 10};
+
+  std::vector<std::string> names;
+  std::vector<task::InputEvent> events;
+
+  for (std::uint32_t i = 0; i < 3 * table_count; ++i) {
+    // A permutation of the arrival order, so the clients have to be sorted.
+    auto number = std::uint64_t{i} * 7919 % (3 * table_count);
+
+    names.push_back("client" + std::to_string(number));
+  }
+
+  for (std::uint32_t i = 0; i < names.size(); ++i) {
+    int time = data.begin_time + static_cast<int>(i * 600 / names.size());
+
+    events.push_back({time, task::InputEvent::Type::CLIENT_ARRIVE, names[i], 0});
+
+    if (i < table_count) {
+      events.push_back({time, task::InputEvent::Type::CLIENT_TAKE_TABLE, names[i], i});
+    } else if (i < 2 * table_count) {
+      events.push_back({time, task::InputEvent::Type::CLIENT_WAIT, names[i], 0});
+    }
+  }
+
+  bench::NullStream out;
+  // Destroyed outside of the timed part.
+  std::optional<task::RevenuerManager> manager;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    manager.reset();
+    manager.emplace(data, out);
+
+    for (auto& event : events) {
+      if (!manager->feed(event)) {
+        state.SkipWithError("Generated event was rejected");
+        return;
+      }
+    }
+    state.ResumeTiming();
+
+    manager->finish();
+  }
+
+  state.SetItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_Closing)->Arg(1'000)->Arg(100'000)->Unit(benchmark::kMillisecond);
+
+} // namespace
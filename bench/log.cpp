@@ -0,0 +1,43 @@
+#include <Allocations.hpp>
+#include <Workload.hpp>
+
+#include <log.hpp>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+// Cost of a record on the calling thread, the writing happens on the log thread.
+// Arguments: 1 to drop records while the queue is full instead of waiting.
+void BM_LogRecord(benchmark::State& state)
+{
+  static bench::NullStream out;
+
+  task::setLogOverflow(
+      state.range(0) != 0 ? task::LogOverflow::DROP : task::LogOverflow::BLOCK
+  );
+  task::flushLog();
+
+  auto allocations = bench::allocationCount();
+  auto dropped = task::droppedLogRecords();
+  int i = 0;
+
+  for (auto _ : state) {
+    LOG_ERROR(out) << "record " << ++i << " of a benchmark";
+  }
+
+  // The count is shared by all threads.
+  if (state.thread_index() == 0) {
+    state.counters["dropped"] = static_cast<double>(task::droppedLogRecords() - dropped);
+  }
+  state.counters["allocs_per_record"] = benchmark::Counter(
+      static_cast<double>(bench::allocationCount() - allocations),
+      benchmark::Counter::kAvgIterations
+  );
+
+  task::flushLog();
+  task::setLogOverflow(task::LogOverflow::BLOCK);
+}
+BENCHMARK(BM_LogRecord)->Arg(0)->Arg(1)->ThreadRange(1, 4);
+
+} // namespace
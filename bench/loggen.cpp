@@ -0,0 +1,60 @@
+#include <LogGenerator.hpp>
+
+#include <charconv>
+#include <iostream>
+#include <string_view>
+
+namespace {
+
+template<typename T>
+bool parseValue(std::string_view text, T& value)
+{
+  auto [end, code] = std::from_chars(text.begin(), text.end(), value);
+
+  return code == std::errc() && end == text.end();
+}
+
+} // namespace
+
+// Writes a generated club day log to stdout, e.g. for profile-guided builds.
+int main(int argc, char** argv)
+{
+  bench::LogGeneratorOptions options;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view name = argv[i];
+    std::string_view value = argv[i + 1];
+    bool valid = false;
+
+    if (name == "--tables") {
+      valid = parseValue(value, options.table_count);
+    } else if (name == "--clients") {
+      valid = parseValue(value, options.client_count);
+    } else if (name == "--events") {
+      valid = parseValue(value, options.event_count);
+    } else if (name == "--queue-pressure") {
+      valid = parseValue(value, options.queue_pressure);
+    } else if (name == "--errors") {
+      valid = parseValue(value, options.error_ratio);
+    } else if (name == "--malformed") {
+      valid = parseValue(value, options.malformed_ratio);
+    } else if (name == "--seed") {
+      valid = parseValue(value, options.seed);
+    }
+
+    if (!valid) {
+      std::cerr << "Usage: " << argv[0]
+                << " [--tables N] [--clients N] [--events N] [--queue-pressure P]"
+                   " [--errors P] [--malformed P] [--seed N]\n";
+      return 1;
+    }
+  }
+
+  if (argc % 2 == 0 || options.table_count == 0 || options.client_count == 0) {
+    std::cerr << "Invalid parameters.\n";
+    return 1;
+  }
+
+  std::ios::sync_with_stdio(false);
+  bench::LogGenerator(options).write(std::cout);
+}
@@ -0,0 +1,44 @@
+#include <Allocations.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::uint64_t> allocation_count{0};
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+namespace bench {
+
+std::uint64_t allocationCount() noexcept
+{
+  return allocation_count.load(std::memory_order_relaxed);
+}
+
+} // namespace bench
+
+BENCHMARK_MAIN();
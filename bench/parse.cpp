@@ -0,0 +1,95 @@
+#include <Allocations.hpp>
+#include <Workload.hpp>
+
+#include <types/InputEvent.hpp>
+#include <types/RevenuerManagerData.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <stdexcept>
+
+namespace {
+
+std::vector<std::string_view> generatedLines(double malformed_ratio)
+{
+  bench::LogGeneratorOptions options;
+  options.event_count = 10'000;
+  options.malformed_ratio = malformed_ratio;
+
+  return bench::eventLines(bench::cachedLog(options));
+}
+
+void BM_InputEventGet(benchmark::State& state)
+{
+  auto lines = generatedLines(0.0);
+  std::uint64_t bytes = 0;
+
+  for (auto line : lines) {
+    bytes += line.size() + 1;
+  }
+
+  auto allocations = bench::allocationCount();
+
+  for (auto _ : state) {
+    for (auto line : lines) {
+      benchmark::DoNotOptimize(task::InputEvent::get(line));
+    }
+  }
+
+  bench::reportThroughput(
+      state, state.iterations() * lines.size(), state.iterations() * bytes,
+      bench::allocationCount() - allocations
+  );
+}
+BENCHMARK(BM_InputEventGet);
+
+// Every tenth line is malformed.
+void BM_InputEventGetMalformed(benchmark::State& state)
+{
+  auto lines = generatedLines(0.1);
+
+  for (auto _ : state) {
+    for (auto line : lines) {
+      try {
+        benchmark::DoNotOptimize(task::InputEvent::get(line));
+      } catch (const std::runtime_error& e) {
+        benchmark::DoNotOptimize(e.what());
+      }
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * lines.size());
+}
+BENCHMARK(BM_InputEventGetMalformed);
+
+void BM_InputEventTryGetMalformed(benchmark::State& state)
+{
+  auto lines = generatedLines(0.1);
+
+  for (auto _ : state) {
+    for (auto line : lines) {
+      benchmark::DoNotOptimize(task::InputEvent::tryGet(line));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * lines.size());
+}
+BENCHMARK(BM_InputEventTryGetMalformed);
+
+void BM_RevenuerManagerDataGet(benchmark::State& state)
+{
+  std::string_view header = "3\n09:00 19:00\n10\n";
+  auto allocations = bench::allocationCount();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(task::RevenuerManagerData::get(header));
+  }
+
+  bench::reportThroughput(
+      state, state.iterations(), state.iterations() * header.size(),
+      bench::allocationCount() - allocations
+  );
+}
+BENCHMARK(BM_RevenuerManagerDataGet);
+
+} // namespace
@@ -0,0 +1,85 @@
+#include <TableStore.hpp>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr uint COST_PER_HOUR = 10;
+constexpr int CLOSING_TIME = 22 * 60;
+
+// Every other table busy since some time of the day.
+void occupyHalf(task::TableStore& store)
+{
+  for (std::size_t table = 0; table < store.size(); table += 2) {
+    store.occupy(table, static_cast<int>(table % CLOSING_TIME));
+  }
+}
+
+// Settling all tables at closing time. Arguments: table count, 1 to end the
+// sessions one by one instead of in one pass.
+void BM_TableSettlement(benchmark::State& state)
+{
+  task::TableStore store(static_cast<std::size_t>(state.range(0)));
+  bool one_by_one = state.range(1) != 0;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    occupyHalf(store);
+    state.ResumeTiming();
+
+    if (one_by_one) {
+      for (std::size_t table = 0; table < store.size(); ++table) {
+        if (store.busySince(table) != task::TableStore::FREE) {
+          store.release(table, CLOSING_TIME, COST_PER_HOUR);
+        }
+      }
+    } else {
+      store.releaseAll(CLOSING_TIME, COST_PER_HOUR);
+    }
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TableSettlement)->ArgsProduct({{1 << 10, 1 << 16}, {0, 1}});
+
+void BM_TableSummary(benchmark::State& state)
+{
+  task::TableStore store(static_cast<std::size_t>(state.range(0)));
+
+  occupyHalf(store);
+  store.releaseAll(CLOSING_TIME, COST_PER_HOUR);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(store.summary());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TableSummary)->Arg(1 << 10)->Arg(1 << 16);
+
+// 64 clubs of 16K tables summed on one to four threads.
+void BM_SummarizeClubs(benchmark::State& state)
+{
+  constexpr std::size_t CLUB_COUNT = 64;
+  constexpr std::size_t TABLE_COUNT = 1 << 14;
+
+  std::vector<task::TableStore> stores(CLUB_COUNT, task::TableStore(TABLE_COUNT));
+  std::vector<const task::TableStore*> clubs;
+
+  for (auto& store : stores) {
+    occupyHalf(store);
+    clubs.push_back(&store);
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        task::summarizeClubs(clubs, static_cast<std::size_t>(state.range(0)))
+    );
+  }
+
+  state.SetItemsProcessed(state.iterations() * CLUB_COUNT * TABLE_COUNT);
+}
+BENCHMARK(BM_SummarizeClubs)->DenseRange(1, 4)->UseRealTime();
+
+} // namespace
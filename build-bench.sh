@@ -0,0 +1,7 @@
+#!/bin/bash
+
+mkdir build
+cd build
+
+cmake .. -DBUILD_BENCH=ON
+make -j4 bench loggen
@@ -3,5 +3,5 @@
 mkdir build
 cd build
 
-cmake .. -DBUILD_TEST=OFF
+cmake .. -DBUILD_TEST=OFF -DCMAKE_BUILD_TYPE=Release
 make -j4
@@ -0,0 +1,25 @@
+#!/bin/bash
+
+# Release build optimized with profiles collected on generated logs.
+
+mkdir build
+cd build
+
+cmake .. -DBUILD_TEST=OFF -DCMAKE_BUILD_TYPE=Release -DPGO=GENERATE
+make -j4 task loggen
+
+rm -rf pgo
+
+./loggen --events 2000000 --tables 10 --clients 100 > pgo-small.txt
+./loggen --events 2000000 --tables 2000 --clients 20000 > pgo-large.txt
+./loggen --events 2000000 --tables 10 --clients 1000 --queue-pressure 1 --errors 0.2 > pgo-busy.txt
+
+for log in pgo-small.txt pgo-large.txt pgo-busy.txt; do
+  ./task $log > /dev/null
+  ./task --stream $log > /dev/null
+done
+
+rm -f pgo-*.txt
+
+cmake .. -DPGO=USE
+make -j4 task
@@ -3,5 +3,5 @@
 mkdir build
 cd build
 
-cmake .. -DBUILD_TEST=ON
+cmake .. -DBUILD_TEST=ON -DCMAKE_BUILD_TYPE=Debug
 make -j4
@@ -0,0 +1,43 @@
+#ifndef _BATCH_HPP
+#define _BATCH_HPP
+
+#include <RevenuerManager.hpp>
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace task {
+
+struct BatchResult {
+  std::string input_path;
+  std::string output_path;
+  bool success{false};
+  // The offending line on malformed input, the reason otherwise.
+  std::string error;
+  std::uint64_t revenue{0};
+  std::uint64_t used_time{0};
+};
+
+// Regular files of a directory, or the paths matching a glob pattern, sorted.
+// Outputs of a previous run (BATCH_OUTPUT_SUFFIX) are skipped.
+std::vector<std::string> collectBatchInputs(const std::string& directory_or_pattern);
+
+// Processes every input with its own RevenuerManager on `jobs` threads (zero means
+// one per hardware thread). Each input is written to the input path followed by
+// BATCH_OUTPUT_SUFFIX, exactly as a single run would print it. A failure only
+// affects the result of its own file.
+std::vector<BatchResult> runBatch(
+    const std::vector<std::string>& inputs, std::size_t jobs,
+    RevenuerManagerOptions options = {}
+);
+
+// One line per input with its revenue and used time, followed by the totals.
+void writeBatchSummary(std::ostream& out, const std::vector<BatchResult>& results);
+
+inline constexpr const char* BATCH_OUTPUT_SUFFIX = ".out";
+
+} // namespace task
+
+#endif
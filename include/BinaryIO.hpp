@@ -0,0 +1,149 @@
+#ifndef _BINARY_IO_HPP
+#define _BINARY_IO_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace task {
+
+// Appends little-endian fixed-width integers, LEB128 varints and length-prefixed
+// strings to a buffer.
+class BinaryWriter {
+public:
+  explicit BinaryWriter(std::string& out) noexcept :
+      out(out)
+  {}
+
+  template<typename T>
+  void fixed(T value)
+  {
+    static_assert(std::is_integral_v<T>);
+    using Unsigned = std::make_unsigned_t<T>;
+
+    auto bits = static_cast<Unsigned>(value);
+
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+      out += static_cast<char>(bits & 0xff);
+      bits = static_cast<Unsigned>(bits >> 8);
+    }
+  }
+
+  void varint(std::uint64_t value)
+  {
+    while (value >= 0x80) {
+      out += static_cast<char>((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+    out += static_cast<char>(value);
+  }
+
+  void bytes(std::string_view value)
+  {
+    out += value;
+  }
+
+  void string(std::string_view value)
+  {
+    varint(value.size());
+    bytes(value);
+  }
+
+private:
+  std::string& out;
+};
+
+// Reads what BinaryWriter wrote. Reading past the end or a malformed varint makes
+// the reader fail, after which every read returns zero.
+class BinaryReader {
+public:
+  explicit BinaryReader(std::string_view data) noexcept :
+      data(data)
+  {}
+
+  template<typename T>
+  T fixed() noexcept
+  {
+    static_assert(std::is_integral_v<T>);
+    using Unsigned = std::make_unsigned_t<T>;
+
+    if (!take(sizeof(T))) {
+      return 0;
+    }
+
+    Unsigned bits = 0;
+
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+      bits |= static_cast<Unsigned>(
+          static_cast<Unsigned>(static_cast<unsigned char>(data[pos - sizeof(T) + i]))
+          << (8 * i)
+      );
+    }
+    return static_cast<T>(bits);
+  }
+
+  std::uint64_t varint() noexcept
+  {
+    std::uint64_t value = 0;
+
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      if (!take(1)) {
+        return 0;
+      }
+
+      auto byte = static_cast<unsigned char>(data[pos - 1]);
+      value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+
+    failed = true;
+    return 0;
+  }
+
+  std::string_view bytes(std::size_t count) noexcept
+  {
+    if (!take(count)) {
+      return {};
+    }
+    return data.substr(pos - count, count);
+  }
+
+  std::string_view string() noexcept
+  {
+    return bytes(varint());
+  }
+
+  // Bytes not read yet.
+  std::size_t remaining() const noexcept
+  {
+    return failed ? 0 : data.size() - pos;
+  }
+
+  bool good() const noexcept
+  {
+    return !failed;
+  }
+
+private:
+  bool take(std::size_t count) noexcept
+  {
+    if (failed || count > data.size() - pos) {
+      failed = true;
+      return false;
+    }
+    pos += count;
+    return true;
+  }
+
+  std::string_view data;
+  std::size_t pos{0};
+  bool failed{false};
+};
+
+} // namespace task
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef _BINARY_LOG_HPP
+#define _BINARY_LOG_HPP
+
+#include <BinaryIO.hpp>
+#include <OutputSink.hpp>
+#include <RevenuerManager.hpp>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace task {
+
+// Compact form of a log. Layout, little-endian:
+//   magic "GRBL", u32 version
+//   u32 table count, u16 opening time, u16 closing time, u32 cost per hour
+//   varint client count, client names as varint length and bytes
+//   records up to the end: u16 minute, u8 type, varint client handle and, for
+//   CLIENT_TAKE_TABLE only, varint zero-based table
+// Client names are stored once, records refer to them by their index.
+inline constexpr std::string_view BINARY_LOG_MAGIC = "GRBL";
+
+bool isBinaryLog(std::string_view data) noexcept;
+
+// Returns false on malformed text, `error_line` is then the offending line. Like a
+// run over the text, conversion stops at the first empty line with nobody in the
+// club. A run would go on past it otherwise, which records cannot express, so the
+// text is rejected at the first line after it.
+bool textToBinaryLog(std::string_view text, std::string& binary, std::string& error_line);
+// Returns false on a malformed binary log.
+bool binaryLogToText(std::string_view binary, std::string& text);
+
+// Reads the events of a binary log. The client IDs of the events point into the
+// log, which has to outlive them.
+class BinaryLogReader {
+public:
+  explicit BinaryLogReader(std::string_view data) noexcept;
+
+  // Reads the header and the client names, std::nullopt if they are malformed.
+  std::optional<RevenuerManagerData> open();
+  // Returns std::nullopt at the end of the log or on a malformed record, good()
+  // tells them apart.
+  std::optional<InputEvent> next() noexcept;
+  bool good() const noexcept;
+
+private:
+  BinaryReader reader;
+  std::vector<std::string_view> names;
+  bool malformed{false};
+};
+
+// Runs a binary log through a RevenuerManager without parsing any text. The
+// transcript is the same as for the text the log was converted from. Returns false
+// if the log is rejected, `error_line` is then the offending event or, for a
+// malformed log, empty.
+bool processBinaryLog(
+    std::string_view data, OutputTarget output, RevenuerManagerOptions options,
+    std::string& error_line
+);
+
+} // namespace task
+
+#endif
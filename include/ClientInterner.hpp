@@ -0,0 +1,46 @@
+#ifndef _CLIENT_INTERNER_HPP
+#define _CLIENT_INTERNER_HPP
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace task {
+
+using ClientHandle = std::uint32_t;
+
+// Maps every distinct client name to a dense handle, so per-client state can live
+// in plain arrays. Names are kept for the lifetime of the interner.
+class ClientInterner {
+  struct Hash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view name) const noexcept
+    {
+      return std::hash<std::string_view>{}(name);
+    }
+  };
+
+public:
+  static constexpr ClientHandle NONE = std::numeric_limits<ClientHandle>::max();
+
+  // Returns the handle of the name, adding it if it is seen for the first time.
+  ClientHandle intern(std::string_view name);
+  // Returns the handle of the name or NONE if it has never been interned.
+  ClientHandle find(std::string_view name) const noexcept;
+
+  std::string_view name(ClientHandle handle) const noexcept;
+  std::size_t size() const noexcept;
+
+private:
+  std::unordered_map<std::string, ClientHandle, Hash, std::equal_to<>> handles;
+  // Views into the keys of `handles`, whose nodes never move.
+  std::vector<std::string_view> names;
+};
+
+} // namespace task
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef _FORMAT_HPP
+#define _FORMAT_HPP
+
+#include <array>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace task {
+
+constexpr int MINUTES_PER_DAY = 24 * 60;
+constexpr std::size_t CLOCK_WIDTH = 5;
+
+// A minute of the day, as every time in the input is.
+constexpr bool validClock(int minutes) noexcept
+{
+  return 0 <= minutes && minutes < MINUTES_PER_DAY;
+}
+
+// "HH:MM" for every minute of the day, packed without separators.
+constexpr std::array<char, MINUTES_PER_DAY * CLOCK_WIDTH> makeClockTable() noexcept
+{
+  std::array<char, MINUTES_PER_DAY * CLOCK_WIDTH> table{};
+
+  for (int minutes = 0; minutes < MINUTES_PER_DAY; ++minutes) {
+    auto* entry = table.data() + minutes * CLOCK_WIDTH;
+    int hour = minutes / 60;
+    int minute = minutes % 60;
+
+    entry[0] = static_cast<char>('0' + hour / 10);
+    entry[1] = static_cast<char>('0' + hour % 10);
+    entry[2] = ':';
+    entry[3] = static_cast<char>('0' + minute / 10);
+    entry[4] = static_cast<char>('0' + minute % 10);
+  }
+
+  return table;
+}
+
+inline constexpr auto CLOCK_TABLE = makeClockTable();
+
+// The minutes must be within a day.
+constexpr std::string_view clockOfDay(int minutes) noexcept
+{
+  return {CLOCK_TABLE.data() + minutes * CLOCK_WIDTH, CLOCK_WIDTH};
+}
+
+static_assert(clockOfDay(0) == "00:00");
+static_assert(clockOfDay(9 * 60 + 5) == "09:05");
+static_assert(clockOfDay(MINUTES_PER_DAY - 1) == "23:59");
+
+template<typename T>
+void appendNumber(std::string& out, T value)
+{
+  static_assert(std::is_integral_v<T>);
+
+  char buffer[24];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+
+  out.append(buffer, result.ptr);
+}
+
+// Appends non-negative minutes as "HH:MM". Durations of a day or more get as many
+// hour digits as they need.
+inline void appendClock(std::string& out, int minutes)
+{
+  if (minutes < MINUTES_PER_DAY) {
+    out += clockOfDay(minutes);
+    return;
+  }
+
+  appendNumber(out, minutes / 60);
+  out += ':';
+  out += clockOfDay(minutes % 60).substr(3);
+}
+
+} // namespace task
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef _FREE_TABLE_INDEX_HPP
+#define _FREE_TABLE_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace task {
+
+// Bitset of free tables with a second level marking the words that have a free
+// table in them, so searches skip 4096 busy tables per summary word.
+class FreeTableIndex {
+public:
+  static constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+  // All `table_count` tables start free.
+  explicit FreeTableIndex(std::size_t table_count = 0);
+
+  void setFree(std::size_t table) noexcept;
+  void setBusy(std::size_t table) noexcept;
+
+  bool isFree(std::size_t table) const noexcept;
+  std::size_t count() const noexcept;
+  std::size_t size() const noexcept;
+
+  // Lowest free table, NONE if every table is busy.
+  std::size_t first() const noexcept;
+  // Lowest free table at or after `from`, NONE if there is none.
+  std::size_t next(std::size_t from) const noexcept;
+
+private:
+  static constexpr std::size_t WORD_BITS = 64;
+
+  std::size_t nextWord(std::size_t word) const noexcept;
+
+  std::vector<std::uint64_t> words;
+  std::vector<std::uint64_t> summary;
+  std::size_t table_count;
+  std::size_t free_count;
+};
+
+} // namespace task
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef _LINE_READER_HPP
+#define _LINE_READER_HPP
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace task {
+
+// Splits the input into lines the same way std::getline does. Lines of an
+// in-memory input are views into it, lines of a stream are views into a buffer
+// reused for every line, so they are only valid until the next call.
+class LineReader {
+public:
+  explicit LineReader(std::istream& input) noexcept;
+  explicit LineReader(std::string_view input) noexcept;
+
+  // Returns std::nullopt once the input is exhausted.
+  std::optional<std::string_view> next();
+
+  // Whether the input is in memory, its lines then stay valid as long as it does.
+  bool inMemory() const noexcept;
+
+  // Bytes of input consumed by the lines returned so far, newlines included.
+  std::size_t offset() const noexcept;
+  // Skips `count` bytes, which have to end with a newline. Returns false if the
+  // input is shorter or the bytes end within a line.
+  [[nodiscard]] bool skip(std::size_t count);
+
+  // FNV-1a hash of the bytes consumed so far. Lines of a stream only count once
+  // trackDigest() has been called, skipped bytes always do.
+  std::uint64_t digest();
+  void trackDigest() noexcept;
+
+private:
+  std::istream* stream{nullptr};
+  std::string buffer;
+  std::size_t consumed{0};
+  bool tracking{false};
+
+  std::string_view data;
+  std::size_t pos{0};
+
+  std::uint64_t hash;
+  // End of the in-memory input hashed so far.
+  std::size_t hashed{0};
+};
+
+} // namespace task
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef _MAPPED_FILE_HPP
+#define _MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string_view>
+
+namespace task {
+
+// Read-only memory mapping of a regular file. Fails (operator bool returns false)
+// for missing files and for anything that cannot be mapped such as pipes, in which
+// case the caller is expected to fall back to a stream.
+class MappedFile {
+public:
+  explicit MappedFile(const char* path) noexcept;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile& operator=(MappedFile&&) = delete;
+
+  explicit operator bool() const noexcept;
+
+  std::string_view view() const noexcept;
+
+private:
+  const char* data{nullptr};
+  std::size_t size{0};
+  bool mapped{false};
+};
+
+} // namespace task
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef _OUTPUT_SINK_HPP
+#define _OUTPUT_SINK_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace task {
+
+// Where an OutputSink writes: a stream, a file descriptor or a string that the
+// output is appended to. Converts implicitly from a stream so that functions taking
+// it also accept std::cout.
+struct OutputTarget {
+  OutputTarget(std::ostream& stream) noexcept :
+      stream(&stream)
+  {}
+
+  static OutputTarget descriptor(int fd) noexcept
+  {
+    OutputTarget target;
+    target.fd = fd;
+    return target;
+  }
+
+  static OutputTarget appendTo(std::string& text) noexcept
+  {
+    OutputTarget target;
+    target.text = &text;
+    return target;
+  }
+
+  std::ostream* stream{nullptr};
+  std::string* text{nullptr};
+  int fd{-1};
+
+private:
+  OutputTarget() noexcept = default;
+};
+
+// Collects output in one contiguous buffer that is written to the target in a
+// single call, so the number of writes depends on the policy and not on the number
+// of lines.
+class OutputSink {
+public:
+  enum class FlushPolicy {
+    // Only flush() writes, e.g. once the whole output is known to be valid.
+    END,
+    // commit() writes once the buffer holds at least `threshold` bytes.
+    THRESHOLD,
+    // commit() always writes and flushes the stream, for interactive use.
+    LINE
+  };
+
+  explicit OutputSink(
+      OutputTarget target, FlushPolicy policy = FlushPolicy::END,
+      std::size_t threshold = 1 << 16
+  ) noexcept;
+
+  OutputSink(const OutputSink&) = delete;
+  OutputSink(OutputSink&& other) noexcept = default;
+
+  OutputSink& operator=(const OutputSink&) = delete;
+  OutputSink& operator=(OutputSink&&) = delete;
+
+  // Output is appended here directly.
+  std::string& buffer() noexcept;
+
+  // Marks the end of a line in the buffer, writes it if the policy asks for it.
+  void commit();
+  // Writes whatever is buffered.
+  void flush();
+  // Drops the buffered output.
+  void discard() noexcept;
+
+  // Number of writes issued to the target so far.
+  std::size_t writeCount() const noexcept;
+  // Bytes handed to the target so far.
+  std::size_t writtenSize() const noexcept;
+  // False once a write to a file descriptor failed, further output is dropped.
+  bool good() const noexcept;
+
+private:
+  void writeDescriptor();
+
+  OutputTarget target;
+  FlushPolicy policy;
+  std::size_t threshold;
+  std::string data;
+  std::size_t write_count{0};
+  std::size_t written_size{0};
+  bool failed{false};
+};
+
+} // namespace task
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef _RECYCLING_QUEUE_HPP
+#define _RECYCLING_QUEUE_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace task {
+
+// FIFO over a ring of slots that are reused once popped. The ring only grows when
+// it is full, so after the first few events the queue stops allocating, unlike
+// std::queue whose deque keeps releasing and acquiring blocks.
+template<typename T>
+class RecyclingQueue {
+public:
+  bool empty() const noexcept
+  {
+    return count == 0;
+  }
+
+  std::size_t size() const noexcept
+  {
+    return count;
+  }
+
+  // The queue must not be empty.
+  T& front() noexcept
+  {
+    return slots[head];
+  }
+
+  // Element `index` places behind the front.
+  const T& operator[](std::size_t index) const noexcept
+  {
+    return slots[(head + index) % slots.size()];
+  }
+
+  void push(const T& value)
+  {
+    if (count == slots.size()) {
+      grow();
+    }
+    slots[(head + count) % slots.size()] = value;
+    ++count;
+  }
+
+  // The queue must not be empty.
+  void pop() noexcept
+  {
+    head = (head + 1) % slots.size();
+    --count;
+  }
+
+private:
+  void grow()
+  {
+    std::vector<T> grown(slots.empty() ? INITIAL_CAPACITY : slots.size() * 2);
+
+    for (std::size_t i = 0; i < count; ++i) {
+      grown[i] = std::move(slots[(head + i) % slots.size()]);
+    }
+    slots = std::move(grown);
+    head = 0;
+  }
+
+  static constexpr std::size_t INITIAL_CAPACITY = 16;
+
+  std::vector<T> slots;
+  std::size_t head{0};
+  std::size_t count{0};
+};
+
+} // namespace task
+
+#endif
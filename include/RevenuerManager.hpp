@@ -1,19 +1,51 @@
 #ifndef _REVENUER_HPP
 #define _REVENUER_HPP
 
+#include <ClientInterner.hpp>
+#include <FreeTableIndex.hpp>
+#include <LineReader.hpp>
+#include <OutputSink.hpp>
+#include <RecyclingQueue.hpp>
+#include <RunStats.hpp>
+#include <SpscRing.hpp>
+#include <TableStore.hpp>
+#include <WaitQueue.hpp>
 #include <types/InputEvent.hpp>
+#include <types/RevenuerManagerData.hpp>
 
-#include <map>
+#include <array>
+#include <ostream>
 #include <optional>
-#include <queue>
-#include <sstream>
 #include <string>
+#include <string_view>
 
 namespace task {
 
-using ClientID = std::string;
 using TableID = int;
 
+struct RevenuerManagerOptions {
+  // Write the transcript to the output stream while the input is processed
+  // instead of holding all of it until the end. On malformed input the lines
+  // accepted before the failing one are already written.
+  bool streaming{false};
+  // Amount of transcript kept in memory before it is written in streaming mode.
+  std::size_t stream_buffer_size{1 << 16};
+  // In streaming mode, write every line as soon as it is complete, for interactive
+  // use.
+  bool flush_each_line{false};
+  // Seat a client who wants to wait at the lowest-numbered free table instead of
+  // answering ICanWaitNoLonger!.
+  bool auto_assign{false};
+  // Write a checkpoint to `checkpoint_path` after every `checkpoint_every` input
+  // events, 0 or an empty path disables it.
+  std::size_t checkpoint_every{0};
+  std::string checkpoint_path;
+  // Read and parse the input, run the events and format the transcript on three
+  // threads connected by rings. The transcript is the same as without it. Only
+  // in-memory input is pipelined and not while checkpoints are written.
+  bool pipelined{false};
+};
+
 class RevenuerManager {
   struct GeneratedEvent {
     enum class Type {
@@ -22,70 +54,245 @@ class RevenuerManager {
       ERROR
     };
 
+    enum class Error {
+      NOT_OPEN_YET,
+      YOU_SHALL_NOT_PASS,
+      CLIENT_UNKNOWN,
+      PLACE_IS_BUSY,
+      I_CAN_WAIT_NO_LONGER
+    };
+
+    // Indexed by Error.
+    static constexpr std::array<std::string_view, 5> ERROR_MESSAGES{
+        "NotOpenYet", "YouShallNotPass", "ClientUnknown", "PlaceIsBusy",
+        "ICanWaitNoLonger!"};
+
     int time;
     Type type;
-    std::map<ClientID, TableID>::iterator client_it;
+    ClientHandle client;
     int table_id;
-    std::string error_message;
+    Error error;
+  };
+
+  // A line of the transcript, handed to the formatter thread in pipelined mode.
+  struct TranscriptLine {
+    enum class Kind {
+      INPUT,
+      GENERATED,
+      END
+    };
+
+    Kind kind;
+    // The echoed input line, or the client ID or error message of a generated event.
+    std::string_view text;
+    int time;
+    GeneratedEvent::Type type;
+    int table_id;
+  };
+
+  // An input line as the reader thread hands it over in pipelined mode.
+  struct ParsedLine {
+    enum class Kind {
+      EVENT,
+      MALFORMED,
+      EMPTY,
+      // The input is exhausted.
+      END
+    };
+
+    Kind kind;
+    std::string_view line;
+    InputEvent event;
   };
 
-  struct TableStatistic {
-    uint revenue{0};
-    uint used_time{0};
+  // A client leaving at closing time. `key` holds the bytes of the name that follow
+  // the prefix shared by all leaving clients, so that most comparisons of the sort
+  // are decided without reading the names.
+  struct LeavingClient {
+    std::uint64_t key;
+    std::string_view name;
+  };
+
+  // Why an input event could not be processed.
+  enum class Failure {
+    NONE,
+    INVALID_EVENT_ORDER,
+    NON_EXISTENT_TABLE,
+    UNKNOWN_EVENT_TYPE
   };
 
 public:
-  RevenuerManager(std::istream& input_data, std::ostream& output_data) noexcept;
+  RevenuerManager(
+      std::istream& input_data, OutputTarget output_data,
+      RevenuerManagerOptions options = {}
+  ) noexcept;
+  // The input has to outlive the manager, e.g. a MappedFile view.
+  RevenuerManager(
+      std::string_view input_data, OutputTarget output_data,
+      RevenuerManagerOptions options = {}
+  ) noexcept;
+
+  // Push mode: the events are passed to feed() one by one instead of being read,
+  // the opening time is written right away.
+  RevenuerManager(
+      const RevenuerManagerData& data, OutputTarget output_data,
+      RevenuerManagerOptions options = {}
+  );
 
   RevenuerManager(const RevenuerManager&) = delete;
   RevenuerManager(RevenuerManager&&) = delete;
 
+  // Throws std::runtime_error with the offending line on malformed input.
   void process();
+  // Returns false on malformed input, errorLine() is then the offending line.
+  [[nodiscard]] bool tryProcess();
+  const std::string& errorLine() const noexcept;
+
+  // Revenue and used time per table, complete once process() has finished.
+  const TableStore& tables() const noexcept;
+  // Which tables are free right now, zero-based.
+  const FreeTableIndex& freeTables() const noexcept;
+  // Number of writes the transcript took so far.
+  std::size_t outputWriteCount() const noexcept;
+
+  // Counters of the run so far, all zero unless built with ENABLE_STATS.
+  const RunStats& runStats() const noexcept;
+  // Writes runStats() as a JSON object, stage times extrapolated from the sampled
+  // iterations.
+  void writeRunStats(std::ostream& out) const;
+
+  // Processes one event in push mode. Returns false if it is out of order or names
+  // a table that does not exist, errorLine() is then the event and the state is as
+  // before it.
+  [[nodiscard]] bool feed(const InputEvent& event);
+  // Ends the day in push mode: the remaining clients leave, then the closing time
+  // and the table statistics are written.
+  void finish();
+  // Ends a day whose input was rejected: in streaming mode the transcript accepted
+  // so far is written, otherwise it is dropped as process() does.
+  void endRejected();
+
+  // Fills `data` with a checkpoint of the state between two input lines: the
+  // tables, clients, wait queue, the input and output offsets and a digest of the
+  // input read. In streaming mode the transcript is flushed first, so a resumed run
+  // can append to it. A stream input is only digested with
+  // `checkpoint_every` set.
+  void checkpoint(std::string& data);
+  // Continues from a checkpoint taken over the same input instead of reading the
+  // header, called before process(). Returns false if the checkpoint is malformed,
+  // out of range or taken over other input, the manager must not be used then.
+  [[nodiscard]] bool restore(std::string_view data);
+  // Bytes of transcript produced so far, counted from the start of the day even
+  // after restore().
+  std::size_t outputOffset() const noexcept;
+  // Bytes of input read so far, including the line that stopped a rejected run. A
+  // pipelined run may have read ahead of the events it ran.
+  std::size_t inputOffset() const noexcept;
+
+  // Live state, valid between events. Tables are zero-based, a table that does not
+  // exist is free and has earned nothing.
+  int currentTime() const noexcept;
+  std::size_t clientCount() const noexcept;
+  std::size_t queueLength() const noexcept;
+  // Table the client sits at, std::nullopt if they are not seated or not in the
+  // club.
+  std::optional<TableID> clientTable(std::string_view client_id) const noexcept;
+  std::optional<std::string_view> tableOccupant(TableID table_id) const noexcept;
+  std::optional<int> busySince(TableID table_id) const noexcept;
+  // Statistics of the table as if the current session ended at `current_time`, or
+  // when it started if that is later.
+  TableStatistic accruedStatistic(TableID table_id, int current_time) const noexcept;
 
 private:
-  void initialize();
+  bool initialize();
+  void setUp(const RevenuerManagerData& data);
+  void writeOpeningTime();
+  bool processEvents();
+  bool processEventsPipelined();
+  // The simulation stage of the pipeline, it consumes `parsed_lines` and feeds
+  // `transcript`.
+  bool simulate(SpscRing<ParsedLine>& parsed_lines);
+  // Runs the generated events and the event deferred past closing time.
+  bool processPending();
   void finalize();
+  void writeCheckpointFile();
+
+  // Formats the line into the transcript, or hands it to the formatter thread.
+  void writeLine(const TranscriptLine& line);
+  static void appendLine(std::string& out, const TranscriptLine& line);
 
   void processGeneratedEvent(const GeneratedEvent& event);
-  void processInputEvent(const InputEvent& event);
+  Failure processInputEvent(const InputEvent& event);
 
   void processClientArrive(const InputEvent& event);
   void processClientTakeTable(const InputEvent& event);
   void processClientWait(const InputEvent& event);
   void processClientLeave(const InputEvent& event);
 
-  void setClientToTable(
-      int current_time, std::map<ClientID, TableID>::iterator it, uint table_id
-  );
-  void unsetClientFromTable(int current_time, std::map<ClientID, TableID>::iterator it);
-  void removeClient(int current_time, std::map<ClientID, TableID>::iterator it);
+  bool validTable(TableID table_id) const noexcept;
+  // Handle of a client that is in the club, ClientInterner::NONE otherwise.
+  ClientHandle findPresentClient(std::string_view client_id) const noexcept;
+
+  void setClientToTable(int current_time, ClientHandle client, uint table_id);
+  void unsetClientFromTable(int current_time, ClientHandle client);
+  void addPresent(ClientHandle client);
+  void removePresent(ClientHandle client) noexcept;
+  void removeClient(int current_time, ClientHandle client);
+  void removeFromQueue(ClientHandle client) noexcept;
+  // Writes the leaving of every client still in the club at closing time and
+  // settles their tables.
   void kickOutLeftClients();
 
-  template<typename Exception, typename... Args>
-  Exception error(Args&&... args)
-  {
-    std::stringstream stream;
+  RevenuerManagerOptions options;
+
+  LineReader in;
+  OutputSink out;
+  // The sink's buffer, the transcript is appended to it directly.
+  std::string& prepared;
 
-    ((stream << "[ERROR] ") << ... << std::forward<Args>(args));
+  std::string error_line;
 
-    return Exception(stream.str() + ".");
-  }
+  RunStats run_stats;
+  StageSampler stage_sampler;
 
-  std::istream& in;
-  std::stringstream prepared;
-  std::ostream& out;
+  // Set while the events are pipelined.
+  SpscRing<TranscriptLine>* transcript{nullptr};
 
-  std::vector<TableStatistic> table_staticstic_list;
+  // Set by restore(), the header has been read by the run that was checkpointed.
+  bool restored{false};
+  std::size_t output_base{0};
+  std::size_t events_since_checkpoint{0};
+  std::string checkpoint_data;
 
-  std::queue<GeneratedEvent> generated_event_queue;
+  RecyclingQueue<GeneratedEvent> generated_event_queue;
+  // Its client_id still points into the line it was parsed from, which stays
+  // alive until the next line is read.
   std::optional<InputEvent> deferred_event;
 
-  std::map<ClientID, TableID> client2table;
+  // Values of client_table for clients that are not seated or not in the club.
+  static constexpr TableID NO_TABLE = -1;
+  static constexpr TableID NOT_PRESENT = -2;
+
+  ClientInterner clients;
+  // Indexed by client handle.
+  std::vector<TableID> client_table;
+  // Handles of the clients in the club in no particular order, so that closing
+  // only visits them.
+  std::vector<ClientHandle> present_clients;
+  // Indexed by client handle, the position in present_clients of a client in the
+  // club.
+  std::vector<std::size_t> present_slot;
+  // Kept to reuse the buffer.
+  std::vector<LeavingClient> leaving_clients;
 
-  std::vector<int> table_time_busy;
-  uint free_table_count;
+  TableStore table_store;
+  // Indexed by table, ClientInterner::NONE for free tables.
+  std::vector<ClientHandle> table_client;
+  FreeTableIndex free_tables;
 
-  std::queue<ClientID> client_queue;
+  WaitQueue client_queue;
+  // Indexed by client handle, WaitQueue::NONE for clients who are not waiting.
+  std::vector<WaitQueue::Slot> client_wait_slot;
 
   int last_time_event{-1};
 
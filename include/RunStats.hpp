@@ -0,0 +1,129 @@
+#ifndef _RUN_STATS_HPP
+#define _RUN_STATS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Set by -DENABLE_STATS=ON. Without it every counter below compiles to nothing.
+#ifndef TASK_STATS
+#define TASK_STATS 0
+#endif
+
+namespace task {
+
+constexpr bool STATS_ENABLED = TASK_STATS != 0;
+
+// Steps of the sequential event loop.
+enum class Stage {
+  READ,
+  PARSE,
+  INPUT_EVENT,
+  GENERATED_EVENT,
+  OUTPUT,
+  COUNT
+};
+
+// Time stamp counter where there is one, nanoseconds otherwise.
+inline std::uint64_t readTicks() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()
+  )
+      .count();
+#endif
+}
+
+// Counters of a run, all zero unless STATS_ENABLED.
+struct RunStats {
+  static constexpr std::size_t STAGE_COUNT = static_cast<std::size_t>(Stage::COUNT);
+
+  // Iterations of the event loop and how many of them were timed.
+  std::uint64_t iterations{0};
+  std::uint64_t sampled_iterations{0};
+  // Ticks spent in every stage by the timed iterations.
+  std::array<std::uint64_t, STAGE_COUNT> stage_ticks{};
+  // Closing time, table statistics and the last write.
+  std::uint64_t finalize_ticks{0};
+
+  // Indexed by InputEvent::Type, generated type and error in declaration order.
+  std::array<std::uint64_t, 4> input_events{};
+  std::array<std::uint64_t, 3> generated_events{};
+  std::array<std::uint64_t, 5> errors{};
+
+  std::size_t peak_pending_events{0};
+  std::size_t peak_wait_queue{0};
+  std::size_t peak_clients{0};
+};
+
+// Times the stages of one event loop iteration in every SAMPLE_INTERVAL, so reading
+// the counter twice per stage stays out of the other iterations. Stage totals are
+// extrapolated from the timed iterations.
+class StageSampler {
+public:
+  static constexpr std::uint32_t SAMPLE_INTERVAL = 256;
+
+  void begin(RunStats& stats) noexcept
+  {
+    if constexpr (STATS_ENABLED) {
+      ++stats.iterations;
+      timed = --countdown == 0;
+
+      if (timed) {
+        countdown = SAMPLE_INTERVAL;
+        ++stats.sampled_iterations;
+        last = readTicks();
+      }
+    }
+  }
+
+  // Charges the time since the previous lap or begin() to `stage`.
+  void lap(RunStats& stats, Stage stage) noexcept
+  {
+    if constexpr (STATS_ENABLED) {
+      if (timed) {
+        auto now = readTicks();
+
+        stats.stage_ticks[static_cast<std::size_t>(stage)] += now - last;
+        last = now;
+      }
+    }
+  }
+
+private:
+  std::uint32_t countdown{1};
+  bool timed{false};
+  std::uint64_t last{0};
+};
+
+template<typename T>
+void raisePeak(T& peak, T value) noexcept
+{
+  if constexpr (STATS_ENABLED) {
+    if (value > peak) {
+      peak = value;
+    }
+  }
+}
+
+// Indices out of range, e.g. of an unknown event type, are not counted.
+template<std::size_t Size>
+void countIn(std::array<std::uint64_t, Size>& counters, std::size_t index) noexcept
+{
+  if constexpr (STATS_ENABLED) {
+    if (index < Size) {
+      ++counters[index];
+    }
+  }
+}
+
+} // namespace task
+
+#endif
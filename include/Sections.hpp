@@ -0,0 +1,29 @@
+#ifndef _SECTIONS_HPP
+#define _SECTIONS_HPP
+
+#include <OutputSink.hpp>
+#include <RevenuerManager.hpp>
+
+#include <string_view>
+
+namespace task {
+
+// Logs of several clubs or days in one input, one after another. Every section is a
+// complete log with its own header and ends where a run of it stops reading: at an
+// empty line with nobody in the club, or at its offending line. Clients still there
+// at an empty line are sent away and the section goes on, so two empty lines always
+// end it.
+//
+// Processes every section with its own RevenuerManager on `jobs` threads (zero
+// means one per hardware thread) and writes the transcripts in input order,
+// separated by an empty line. A malformed section ends with its offending line, as
+// a single run prints it, and does not affect the others. Returns the number of
+// malformed sections.
+std::size_t processSections(
+    std::string_view input, OutputTarget output, std::size_t jobs,
+    RevenuerManagerOptions options = {}
+);
+
+} // namespace task
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef _SPSC_RING_HPP
+#define _SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace task {
+
+// Bounded FIFO between exactly one producer and one consumer thread, without
+// locks. Each side keeps its own copy of the other side's index and only reloads
+// it when the ring looks full or empty, so the indices' cache lines move between
+// cores once per run of items instead of once per item.
+template<typename T>
+class SpscRing {
+public:
+  // The capacity is rounded up to a power of two.
+  explicit SpscRing(std::size_t capacity) :
+      slots(roundUp(capacity)),
+      mask(slots.size() - 1)
+  {}
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing(SpscRing&&) = delete;
+
+  // Producer side. Returns false if the ring is full.
+  bool tryPush(const T& value) noexcept
+  {
+    auto tail = write_index.load(std::memory_order_relaxed);
+
+    if (tail - cached_read_index == slots.size()) {
+      cached_read_index = read_index.load(std::memory_order_acquire);
+
+      if (tail - cached_read_index == slots.size()) {
+        return false;
+      }
+    }
+
+    slots[tail & mask] = value;
+    write_index.store(tail + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  // Producer side, waits while the ring is full.
+  void push(const T& value) noexcept
+  {
+    while (!tryPush(value)) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Consumer side. Returns false if the ring is empty.
+  bool tryPop(T& value) noexcept
+  {
+    auto head = read_index.load(std::memory_order_relaxed);
+
+    if (head == cached_write_index) {
+      cached_write_index = write_index.load(std::memory_order_acquire);
+
+      if (head == cached_write_index) {
+        return false;
+      }
+    }
+
+    value = slots[head & mask];
+    read_index.store(head + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  // Consumer side, waits while the ring is empty.
+  T pop() noexcept
+  {
+    T value;
+
+    while (!tryPop(value)) {
+      std::this_thread::yield();
+    }
+    return value;
+  }
+
+private:
+  static std::size_t roundUp(std::size_t capacity) noexcept
+  {
+    std::size_t size = 1;
+
+    while (size < capacity) {
+      size *= 2;
+    }
+    return size;
+  }
+
+  std::vector<T> slots;
+  std::size_t mask;
+
+  // Written by the consumer.
+  alignas(64) std::atomic<std::size_t> read_index{0};
+  std::size_t cached_write_index{0};
+
+  // Written by the producer.
+  alignas(64) std::atomic<std::size_t> write_index{0};
+  std::size_t cached_read_index{0};
+};
+
+} // namespace task
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef _TABLE_STORE_HPP
+#define _TABLE_STORE_HPP
+
+#include <Format.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <sys/types.h>
+#include <vector>
+
+namespace task {
+
+struct TableStatistic {
+  uint revenue{0};
+  uint used_time{0};
+};
+
+// Totals over the tables of one or more clubs.
+struct TableSummary {
+  std::uint64_t revenue{0};
+  std::uint64_t used_time{0};
+  std::size_t busy_tables{0};
+
+  TableSummary& operator+=(const TableSummary& other) noexcept
+  {
+    revenue += other.revenue;
+    used_time += other.used_time;
+    busy_tables += other.busy_tables;
+    return *this;
+  }
+};
+
+// Every started hour is paid in full. Divides by multiplying and shifting, which
+// is exact for any session within a day and works on SIMD lanes.
+constexpr uint billedHours(uint minutes) noexcept
+{
+  return ((minutes + 59) * 2185) >> 17;
+}
+
+constexpr bool billedHoursExact() noexcept
+{
+  for (uint minutes = 0; minutes <= MINUTES_PER_DAY; ++minutes) {
+    if (billedHours(minutes) != (minutes + 59) / 60) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(billedHoursExact());
+
+// Revenue, used time and start of the running session of every table, kept as
+// separate arrays aligned to cache lines and padded with free tables to whole SIMD
+// registers, so that settling or summing all tables runs over full vectors.
+class TableStore {
+  // Lanes of the widest kernel, 8 x 32 bits for AVX2.
+  static constexpr std::size_t LANES = 8;
+  static constexpr std::size_t ALIGNMENT = 64;
+
+  template<typename T>
+  struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) noexcept
+    {}
+
+    T* allocate(std::size_t count)
+    {
+      return static_cast<T*>(
+          ::operator new(count * sizeof(T), std::align_val_t(ALIGNMENT))
+      );
+    }
+
+    void deallocate(T* pointer, std::size_t) noexcept
+    {
+      ::operator delete(pointer, std::align_val_t(ALIGNMENT));
+    }
+
+    bool operator==(const AlignedAllocator&) const noexcept = default;
+  };
+
+  template<typename T>
+  using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+public:
+  // busySince() of a free table.
+  static constexpr int FREE = -1;
+
+  // All `table_count` tables start free with nothing earned.
+  explicit TableStore(std::size_t table_count = 0);
+
+  std::size_t size() const noexcept;
+
+  // FREE if nobody sits at the table.
+  int busySince(std::size_t table) const noexcept
+  {
+    return busy_since[table];
+  }
+
+  TableStatistic statistic(std::size_t table) const noexcept
+  {
+    return {revenue[table], used_time[table]};
+  }
+
+  // The statistic as if the running session ended at `time`, which must not be
+  // before it started.
+  TableStatistic accrued(std::size_t table, int time, uint cost_per_hour) const noexcept;
+
+  void occupy(std::size_t table, int time) noexcept
+  {
+    busy_since[table] = time;
+  }
+
+  // Ends the running session at `time`, the table must be busy.
+  void release(std::size_t table, int time, uint cost_per_hour) noexcept;
+  // Ends every running session at `time` in one pass over all tables.
+  void releaseAll(int time, uint cost_per_hour) noexcept;
+
+  // Overwrites the state of a table, as a checkpoint holds it.
+  void restore(std::size_t table, TableStatistic statistic, int since) noexcept;
+
+  // Totals of the finished sessions and the number of busy tables.
+  TableSummary summary() const noexcept;
+
+private:
+  std::size_t table_count;
+
+  AlignedVector<int> busy_since;
+  AlignedVector<uint> revenue;
+  AlignedVector<uint> used_time;
+};
+
+// Sums the summaries of the clubs on `jobs` threads, zero means one per hardware
+// thread.
+TableSummary
+summarizeClubs(const std::vector<const TableStore*>& stores, std::size_t jobs);
+
+} // namespace task
+
+#endif
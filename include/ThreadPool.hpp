@@ -0,0 +1,70 @@
+#ifndef _THREAD_POOL_HPP
+#define _THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace task {
+
+// Fixed set of worker threads running one parallel loop at a time.
+class ThreadPool {
+public:
+  // Zero means one thread per hardware thread.
+  explicit ThreadPool(std::size_t thread_count = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+
+  std::size_t size() const noexcept;
+
+  // Calls task(i) for every i in [0, count) on the workers and the calling thread
+  // and returns once all calls are done. Every thread starts on its own contiguous
+  // share of the indices and, once it runs out, steals half of what another thread
+  // has left, so tasks of uneven length still keep every thread busy. The count
+  // must fit in 32 bits and tasks must not throw.
+  void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+
+private:
+  using Task = std::function<void(std::size_t)>;
+
+  // Indices [begin, end) a thread has yet to run, packed into one word so that the
+  // owner taking from the front and thieves taking from the back agree through a
+  // single compare-and-swap.
+  struct alignas(64) Range {
+    std::atomic<std::uint64_t> bounds{0};
+  };
+
+  void work(std::size_t participant);
+  void runTasks(std::size_t participant, const Task& task);
+
+  std::optional<std::size_t> takeOwn(std::size_t participant) noexcept;
+  std::optional<std::size_t> steal(std::size_t participant) noexcept;
+
+  std::vector<std::thread> workers;
+  // One per participant, the calling thread is participant 0.
+  std::unique_ptr<Range[]> ranges;
+
+  std::mutex mutex;
+  std::condition_variable job_ready;
+  std::condition_variable job_done;
+
+  const Task* job{nullptr};
+  std::atomic<std::size_t> remaining{0};
+  // Workers still inside the current loop, which must not outlive the task.
+  std::size_t active_workers{0};
+  std::size_t generation{0};
+  bool stopping{false};
+};
+
+} // namespace task
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef _VALIDATION_HPP
+#define _VALIDATION_HPP
+
+#include <string>
+#include <string_view>
+
+namespace task {
+
+// Checks a text log without running it: the header, then the syntax of every event,
+// its table against the table count and the order of the times. The events are
+// split into chunks on line boundaries that are checked on `jobs` threads, zero
+// means one per hardware thread. Whether the day ends at an empty line depends on
+// who is in the club, so a log with one before its first offending line is run.
+//
+// Returns false with `error_line` set to the first offending line, the line a run
+// stops at. The one difference is a table out of range for a client who is not in
+// the club before any empty line: a run answers ClientUnknown to it, validation
+// rejects it.
+[[nodiscard]] bool
+validateLog(std::string_view input, std::size_t jobs, std::string& error_line);
+
+} // namespace task
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef _WAIT_QUEUE_HPP
+#define _WAIT_QUEUE_HPP
+
+#include <ClientInterner.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace task {
+
+// FIFO of waiting clients in a fixed pool of slots, allocated once. The slots are
+// linked into a ring, so a client can leave from anywhere in the queue in O(1)
+// through the slot push() returned for it.
+class WaitQueue {
+public:
+  using Slot = std::uint32_t;
+
+  static constexpr Slot NONE = std::numeric_limits<Slot>::max();
+
+  explicit WaitQueue(std::size_t capacity = 0);
+
+  bool empty() const noexcept;
+  bool full() const noexcept;
+  std::size_t size() const noexcept;
+
+  // The queue must not be full.
+  Slot push(ClientHandle client) noexcept;
+  // The queue must not be empty.
+  ClientHandle front() const noexcept;
+  void pop() noexcept;
+  void remove(Slot slot) noexcept;
+  // Removes every client at once, the slots handed out so far become invalid.
+  void clear() noexcept;
+
+  // Calls `function` with every waiting client, front first.
+  template<typename Function>
+  void forEach(Function&& function) const
+  {
+    for (auto slot = next[sentinel]; slot != sentinel; slot = next[slot]) {
+      function(clients[slot]);
+    }
+  }
+
+private:
+  void unlink(Slot slot) noexcept;
+
+  // Slot `capacity` is the sentinel closing the ring, free slots are chained
+  // through `next`.
+  std::vector<ClientHandle> clients;
+  std::vector<Slot> next;
+  std::vector<Slot> prev;
+  Slot sentinel;
+  Slot free_head;
+  std::size_t count{0};
+};
+
+} // namespace task
+
+#endif
@@ -0,0 +1,233 @@
+#ifndef _GRAMMAR_HPP
+#define _GRAMMAR_HPP
+
+#include <base_parser/Numbers.hpp>
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace base_parser {
+
+// Building blocks for line formats that are declared as a sequence of fields and
+// compiled into one parser, with no calls left once inlined. Every element is a type
+// with
+//   template<typename Result>
+//   static constexpr bool parse(Cursor& cursor, Result& result) noexcept;
+// that consumes its text, stores what it read through a member pointer of `Result`
+// and returns false with the cursor at the offending character otherwise.
+
+struct Cursor {
+  std::string_view text;
+  std::size_t pos{0};
+
+  constexpr bool atEnd() const noexcept
+  {
+    return pos >= text.size();
+  }
+
+  // Zero past the end.
+  constexpr char peek() const noexcept
+  {
+    return atEnd() ? '\0' : text[pos];
+  }
+};
+
+template<auto Member>
+struct MemberTraits;
+
+template<typename Result, typename Value, Value Result::*Member>
+struct MemberTraits<Member> {
+  using type = Value;
+};
+
+template<auto Member>
+using MemberType = typename MemberTraits<Member>::type;
+
+// The character `Value`.
+template<char Value>
+struct Literal {
+  template<typename Result>
+  static constexpr bool parse(Cursor& cursor, Result&) noexcept
+  {
+    if (cursor.atEnd() || cursor.text[cursor.pos] != Value) {
+      return false;
+    }
+    ++cursor.pos;
+    return true;
+  }
+};
+
+// The character `Value` or the end of the text.
+template<char Value>
+struct LiteralOrEnd {
+  template<typename Result>
+  static constexpr bool parse(Cursor& cursor, Result& result) noexcept
+  {
+    return cursor.atEnd() || Literal<Value>::parse(cursor, result);
+  }
+};
+
+struct End {
+  template<typename Result>
+  static constexpr bool parse(Cursor& cursor, Result&) noexcept
+  {
+    return cursor.atEnd();
+  }
+};
+
+// A fixed-width "HH:MM" time of day, stored as minutes since midnight.
+template<auto Member>
+struct Clock {
+  static constexpr std::size_t WIDTH = 5;
+
+  template<typename Result>
+  static constexpr bool parse(Cursor& cursor, Result& result) noexcept
+  {
+    auto minutes = parseClock(cursor.text.substr(cursor.pos, WIDTH));
+
+    if (minutes < 0) {
+      return false;
+    }
+    result.*Member = minutes;
+    cursor.pos += WIDTH;
+    return true;
+  }
+};
+
+// One digit between `Min` and `Max`, stored as its value converted to the member's
+// type, e.g. an enumeration.
+template<char Min, char Max, auto Member>
+struct Digit {
+  static_assert('0' <= Min && Min <= Max && Max <= '9');
+
+  template<typename Result>
+  static constexpr bool parse(Cursor& cursor, Result& result) noexcept
+  {
+    auto value = cursor.peek();
+
+    if (value < Min || value > Max) {
+      return false;
+    }
+    result.*Member = static_cast<MemberType<Member>>(value - '0');
+    ++cursor.pos;
+    return true;
+  }
+};
+
+enum class LeadingZeros {
+  ALLOWED,
+  FORBIDDEN
+};
+
+// A run of decimal digits that fits the unsigned member and is at least `Min`.
+template<
+    auto Member, MemberType<Member> Min = 0, LeadingZeros Zeros = LeadingZeros::ALLOWED>
+struct Number {
+  template<typename Result>
+  static constexpr bool parse(Cursor& cursor, Result& result) noexcept
+  {
+    MemberType<Member> value = 0;
+    auto first = cursor.peek();
+
+    if (!isDigit(first) || (Zeros == LeadingZeros::FORBIDDEN && first == '0')) {
+      return false;
+    }
+
+    for (; isDigit(cursor.peek()); ++cursor.pos) {
+      if (!appendDigit(value, cursor.peek())) {
+        return false;
+      }
+    }
+
+    if (value < Min) {
+      return false;
+    }
+    result.*Member = value;
+    return true;
+  }
+};
+
+// A set of characters, tested with one lookup.
+class CharClass {
+public:
+  constexpr CharClass(std::string_view ranges) noexcept
+  {
+    // Pairs of inclusive bounds, "azAZ" is every letter.
+    for (std::size_t i = 0; i + 1 < ranges.size(); i += 2) {
+      for (int value = ranges[i]; value <= ranges[i + 1]; ++value) {
+        members[static_cast<unsigned char>(value)] = true;
+      }
+    }
+  }
+
+  constexpr bool contains(char value) const noexcept
+  {
+    return members[static_cast<unsigned char>(value)];
+  }
+
+private:
+  std::array<bool, 256> members{};
+};
+
+// A non-empty run of characters of `Class`, stored as a view into the text.
+template<const CharClass& Class, auto Member>
+struct Run {
+  template<typename Result>
+  static constexpr bool parse(Cursor& cursor, Result& result) noexcept
+  {
+    auto begin = cursor.pos;
+
+    while (!cursor.atEnd() && Class.contains(cursor.peek())) {
+      ++cursor.pos;
+    }
+
+    if (cursor.pos == begin) {
+      return false;
+    }
+    result.*Member = cursor.text.substr(begin, cursor.pos - begin);
+    return true;
+  }
+};
+
+// `First` and `Rest`, or nothing if `First` does not match, which then must not
+// consume anything, as a Literal. Whether they were there is stored in `Present`.
+template<auto Present, typename First, typename... Rest>
+struct Optional {
+  template<typename Result>
+  static constexpr bool parse(Cursor& cursor, Result& result) noexcept
+  {
+    result.*Present = First::parse(cursor, result);
+
+    return !(result.*Present) || (Rest::parse(cursor, result) && ...);
+  }
+};
+
+// The line of `data` holding the character at `index`, or the last character if the
+// index is past the end. A newline belongs to the line it ends.
+std::string_view lineAt(std::string_view data, std::size_t index) noexcept;
+
+// A whole format. Returns false on malformed text and, if `error_pos` is given,
+// stores the position of the offending character there.
+template<typename... Elements>
+struct Grammar {
+  template<typename Result>
+  static constexpr bool
+  parse(std::string_view text, Result& result, std::size_t* error_pos = nullptr) noexcept
+  {
+    Cursor cursor{text};
+
+    if ((Elements::parse(cursor, result) && ...)) {
+      return true;
+    }
+
+    if (error_pos != nullptr) {
+      *error_pos = cursor.pos;
+    }
+    return false;
+  }
+};
+
+} // namespace base_parser
+
+#endif
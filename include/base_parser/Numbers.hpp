@@ -0,0 +1,59 @@
+#ifndef _NUMBERS_HPP
+#define _NUMBERS_HPP
+
+#include <limits>
+#include <string_view>
+
+namespace base_parser {
+
+constexpr bool isDigit(char value) noexcept
+{
+  return '0' <= value && value <= '9';
+}
+
+// Appends a decimal digit to the value. Returns false if the result does not fit.
+template<typename T>
+constexpr bool appendDigit(T& value, char digit) noexcept
+{
+  T digit_value = digit - '0';
+
+  if (value > (std::numeric_limits<T>::max() - digit_value) / 10) {
+    return false;
+  }
+
+  value = value * 10 + digit_value;
+
+  return true;
+}
+
+// Parses a fixed-width "HH:MM" clock into minutes since midnight, -1 if the text
+// is not a valid time of day.
+constexpr int parseClock(std::string_view text) noexcept
+{
+  if (text.size() != 5 || text[2] != ':') {
+    return -1;
+  }
+
+  if (!isDigit(text[0]) || !isDigit(text[1]) || !isDigit(text[3]) || !isDigit(text[4])) {
+    return -1;
+  }
+
+  int hour = (text[0] - '0') * 10 + (text[1] - '0');
+  int minute = (text[3] - '0') * 10 + (text[4] - '0');
+
+  if (hour > 23 || minute > 59) {
+    return -1;
+  }
+
+  return hour * 60 + minute;
+}
+
+static_assert(parseClock("00:00") == 0);
+static_assert(parseClock("23:59") == 23 * 60 + 59);
+static_assert(parseClock("24:00") == -1);
+static_assert(parseClock("09:60") == -1);
+static_assert(parseClock("0900") == -1);
+
+} // namespace base_parser
+
+#endif
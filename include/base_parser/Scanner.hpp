@@ -0,0 +1,17 @@
+#ifndef _SCANNER_HPP
+#define _SCANNER_HPP
+
+#include <cstddef>
+#include <string_view>
+
+namespace base_parser {
+
+// Delimiter search over 32 (AVX2) or 16 (SSE2) bytes at a time, depending on the
+// instruction set the translation unit is compiled for, with a scalar tail.
+
+// Position of the first `value` at or after `from`, data.size() if there is none.
+std::size_t find(std::string_view data, char value, std::size_t from = 0) noexcept;
+
+} // namespace base_parser
+
+#endif
@@ -1,19 +1,78 @@
 #ifndef _DEFINES_HPP
 #define _DEFINES_HPP
 
+#include <Format.hpp>
+
+#include <cstdint>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Lowest level whose records are compiled in: 0 debug, 1 info, 2 warning, 3 error.
+// Calls below it compile to nothing.
+#ifndef TASK_LOG_LEVEL
+#ifdef NDEBUG
+#define TASK_LOG_LEVEL 1
+#else
+#define TASK_LOG_LEVEL 0
+#endif
+#endif
+
+namespace task {
+
+enum class LogLevel {
+  DEBUG,
+  INFO,
+  WARNING,
+  ERROR
+};
+
+// What a call site does when the queue of records waiting to be written is full.
+enum class LogOverflow {
+  // Waits for the log thread to make room.
+  BLOCK,
+  // Drops the record and counts it.
+  DROP
+};
+
+// Records below `level` are dropped at the call site, by default nothing is.
+void setLogLevel(LogLevel level) noexcept;
+void setLogOverflow(LogOverflow policy) noexcept;
+
+// Waits until every record logged so far is written. Records to a stream other than
+// std::cout, std::cerr and std::clog already are once their statement ends, so the
+// stream may be destroyed right after it.
+void flushLog();
+// Records dropped so far because the queue was full.
+std::uint64_t droppedLogRecords() noexcept;
+
+} // namespace task
 
 namespace defines_details {
 
 struct LogStreamer;
 
+// Character types are integral too, but not numbers to a stream.
+template<typename T>
+constexpr bool IS_CHARACTER = std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+                              std::is_same_v<T, unsigned char> ||
+                              std::is_same_v<T, wchar_t> || std::is_same_v<T, char8_t> ||
+                              std::is_same_v<T, char16_t> || std::is_same_v<T, char32_t>;
+
 LogStreamer log_info_impl(std::ostream& out = std::cout);
 LogStreamer log_debug_impl(std::ostream& out = std::cout);
 LogStreamer log_warning_impl(std::ostream& out = std::cout);
 LogStreamer log_error_impl(std::ostream& out = std::cerr);
 
+// Formats a record into a buffer of the calling thread and hands it to the log
+// thread once the statement ends, which writes the records in batches. Records of
+// one thread keep their order, records of several threads never interleave
+// mid-line. A record to a stream other than the standard ones is waited for at the
+// end of its statement, as the caller may destroy the stream right after it.
 struct LogStreamer {
-  explicit LogStreamer(std::ostream& out_) noexcept;
+  LogStreamer(std::ostream& out_, task::LogLevel level) noexcept;
   ~LogStreamer();
 
   LogStreamer(const LogStreamer& other) = delete;
@@ -25,7 +84,29 @@ struct LogStreamer {
   template<typename T>
   LogStreamer& operator<<(T&& value)
   {
-    out << std::forward<T>(value);
+    using Value = std::remove_cvref_t<T>;
+
+    if (text == nullptr) {
+      return *this;
+    }
+
+    if constexpr (std::is_convertible_v<T, std::string_view>) {
+      *text += std::string_view(value);
+    } else if constexpr (std::is_same_v<Value, char> ||
+                         std::is_same_v<Value, signed char> ||
+                         std::is_same_v<Value, unsigned char>)
+    {
+      // Characters, as a stream prints them.
+      *text += static_cast<char>(value);
+    } else if constexpr (std::is_integral_v<Value> && !std::is_same_v<Value, bool> &&
+                         !IS_CHARACTER<Value>)
+    {
+      task::appendNumber(*text, value);
+    } else {
+      std::ostringstream stream;
+      stream << std::forward<T>(value);
+      *text += stream.view();
+    }
 
     return *this;
   }
@@ -38,7 +119,13 @@ private:
 
   LogStreamer(LogStreamer& other) noexcept;
 
-  std::ostream& out;
+  void takeFrom(LogStreamer& other) noexcept;
+
+  std::ostream* out;
+  // The thread's buffer, or `own` while a record is formatted inside another one.
+  // Null for a record below the runtime level.
+  std::string* text{nullptr};
+  std::string own;
   bool holded{true};
 };
 
@@ -57,13 +144,24 @@ static_assert(std::is_move_constructible_v<LogStreamer>);
 
 } // namespace defines_details
 
-#define LOG_INFO(...) (defines_details::log_info_impl(__VA_ARGS__))
-#ifndef NDEBUG
+// LOG_ERROR(stream) << ... logs to `stream`, by default std::cerr for errors and
+// std::cout otherwise. The standard streams are written asynchronously, any other
+// stream before the statement ends.
+#if TASK_LOG_LEVEL <= 0
 #define LOG_DEBUG(...) (defines_details::log_debug_impl(__VA_ARGS__))
 #else
 #define LOG_DEBUG(...) (defines_details::NullLogStreamer{})
 #endif
+#if TASK_LOG_LEVEL <= 1
+#define LOG_INFO(...) (defines_details::log_info_impl(__VA_ARGS__))
+#else
+#define LOG_INFO(...) (defines_details::NullLogStreamer{})
+#endif
+#if TASK_LOG_LEVEL <= 2
 #define LOG_WARNING(...) (defines_details::log_warning_impl(__VA_ARGS__))
+#else
+#define LOG_WARNING(...) (defines_details::NullLogStreamer{})
+#endif
 #define LOG_ERROR(...) (defines_details::log_error_impl(__VA_ARGS__))
 
 #endif
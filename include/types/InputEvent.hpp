@@ -1,7 +1,9 @@
 #ifndef _EVENT_HPP
 #define _EVENT_HPP
 
-#include <string>
+#include <optional>
+#include <string_view>
+#include <sys/types.h>
 
 namespace task {
 
@@ -13,11 +15,17 @@ struct InputEvent {
     CLIENT_LEAVE,
   };
 
+  // Returns std::nullopt if the line is malformed.
+  static std::optional<InputEvent> tryGet(std::string_view view);
+  // Throws std::runtime_error with the line if it is malformed.
   static InputEvent get(std::string_view view);
+  // Whether `client_id` is a client ID as the event lines spell them.
+  static bool validClientId(std::string_view client_id) noexcept;
 
   int time;
   Type type;
-  std::string client_id;
+  // Points into the parsed line.
+  std::string_view client_id;
   uint table_id;
 };
 
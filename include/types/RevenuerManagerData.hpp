@@ -1,6 +1,7 @@
 #ifndef REVENUER_MANAGER_DATA_HPP
 #define REVENUER_MANAGER_DATA_HPP
 
+#include <optional>
 #include <string_view>
 
 namespace task {
@@ -11,6 +12,12 @@ struct RevenuerManagerData {
   int end_time;
   unsigned int cost_per_hour;
 
+  // Returns std::nullopt on malformed input and points `error_line`, if given, at
+  // the offending line of `view`, or at "Invalid unsigned int was parsed." for a
+  // number that does not fit.
+  static std::optional<RevenuerManagerData>
+  tryGet(std::string_view view, std::string_view* error_line = nullptr) noexcept;
+  // Throws std::runtime_error with the offending line.
   static RevenuerManagerData get(std::string_view view);
 };
 
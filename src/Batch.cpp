@@ -0,0 +1,157 @@
+#include <Batch.hpp>
+#include <MappedFile.hpp>
+#include <ThreadPool.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <glob.h>
+
+namespace task {
+
+namespace {
+
+std::string formatDuration(std::uint64_t minutes)
+{
+  auto hours = std::to_string(minutes / 60);
+  auto rest = std::to_string(minutes % 60);
+
+  if (hours.size() < 2) {
+    hours.insert(0, 1, '0');
+  }
+  if (rest.size() < 2) {
+    rest.insert(0, 1, '0');
+  }
+
+  return hours + ":" + rest;
+}
+
+bool isBatchOutput(const std::string& path)
+{
+  std::string_view suffix = BATCH_OUTPUT_SUFFIX;
+
+  return path.size() >= suffix.size() &&
+         path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void processFile(BatchResult& result, RevenuerManagerOptions options)
+{
+  MappedFile mapped(result.input_path.c_str());
+
+  if (!mapped) {
+    result.error = "Input file not found.";
+    return;
+  }
+
+  std::ofstream out(result.output_path, std::ios::binary | std::ios::trunc);
+
+  if (!out) {
+    result.error = "Output file cannot be created.";
+    return;
+  }
+
+  RevenuerManager manager(mapped.view(), out, options);
+
+  if (!manager.tryProcess()) {
+    out << manager.errorLine() << '\n';
+    result.error = manager.errorLine();
+    return;
+  }
+
+  auto summary = manager.tables().summary();
+
+  result.revenue = summary.revenue;
+  result.used_time = summary.used_time;
+
+  result.success = static_cast<bool>(out.flush());
+
+  if (!result.success) {
+    result.error = "Output file cannot be written.";
+  }
+}
+
+} // namespace
+
+std::vector<std::string> collectBatchInputs(const std::string& directory_or_pattern)
+{
+  std::vector<std::string> inputs;
+  std::error_code code;
+
+  if (std::filesystem::is_directory(directory_or_pattern, code)) {
+    for (auto& entry : std::filesystem::directory_iterator(directory_or_pattern, code)) {
+      if (entry.is_regular_file(code)) {
+        inputs.push_back(entry.path().string());
+      }
+    }
+  } else {
+    glob_t matches;
+
+    if (::glob(directory_or_pattern.c_str(), 0, nullptr, &matches) == 0) {
+      for (std::size_t i = 0; i < matches.gl_pathc; ++i) {
+        inputs.emplace_back(matches.gl_pathv[i]);
+      }
+    }
+    ::globfree(&matches);
+  }
+
+  std::erase_if(inputs, isBatchOutput);
+  std::sort(inputs.begin(), inputs.end());
+
+  return inputs;
+}
+
+std::vector<BatchResult> runBatch(
+    const std::vector<std::string>& inputs, std::size_t jobs,
+    RevenuerManagerOptions options
+)
+{
+  std::vector<BatchResult> results(inputs.size());
+
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    results[i].input_path = inputs[i];
+    results[i].output_path = inputs[i] + BATCH_OUTPUT_SUFFIX;
+  }
+
+  if (jobs == 0) {
+    jobs = std::thread::hardware_concurrency();
+  }
+
+  ThreadPool pool(std::max<std::size_t>(1, std::min(jobs, inputs.size())));
+
+  pool.parallelFor(results.size(), [&](std::size_t i) {
+    try {
+      processFile(results[i], options);
+    } catch (const std::exception& e) {
+      results[i].success = false;
+      results[i].error = e.what();
+    }
+  });
+
+  return results;
+}
+
+void writeBatchSummary(std::ostream& out, const std::vector<BatchResult>& results)
+{
+  std::uint64_t revenue = 0;
+  std::uint64_t used_time = 0;
+  std::size_t failed = 0;
+
+  for (auto& result : results) {
+    if (!result.success) {
+      out << result.input_path << " ERROR " << result.error << '\n';
+      ++failed;
+      continue;
+    }
+
+    out << result.input_path << ' ' << result.revenue << ' '
+        << formatDuration(result.used_time) << '\n';
+
+    revenue += result.revenue;
+    used_time += result.used_time;
+  }
+
+  out << "TOTAL " << revenue << ' ' << formatDuration(used_time) << '\n';
+  out << "FAILED " << failed << '\n';
+}
+
+} // namespace task
@@ -0,0 +1,281 @@
+#include <BinaryLog.hpp>
+#include <ClientInterner.hpp>
+#include <Format.hpp>
+#include <LineReader.hpp>
+
+#include <limits>
+#include <ostream>
+
+namespace task {
+
+namespace {
+
+constexpr std::uint32_t BINARY_LOG_VERSION = 1;
+
+// Whether anybody is still in the club after the `events`, which are well-formed.
+// False as well if a run rejects one of them, it then stops before reading on.
+bool clientsPresentAfter(const RevenuerManagerData& header, std::string_view events)
+{
+  std::ostream discarded(nullptr);
+  RevenuerManager manager(header, discarded, {.streaming = true});
+  LineReader in(events);
+
+  while (auto line = in.next()) {
+    if (!manager.feed(*InputEvent::tryGet(*line))) {
+      return false;
+    }
+  }
+  return manager.clientCount() > 0;
+}
+
+} // namespace
+
+bool isBinaryLog(std::string_view data) noexcept
+{
+  return data.starts_with(BINARY_LOG_MAGIC);
+}
+
+bool textToBinaryLog(std::string_view text, std::string& binary, std::string& error_line)
+{
+  LineReader in(text);
+  std::string header_text;
+
+  for (int i = 0; i < 3; ++i) {
+    auto line = in.next();
+
+    if (!line.has_value()) {
+      break;
+    }
+    header_text += *line;
+    header_text += '\n';
+  }
+
+  std::string_view header_error_line;
+  auto header = RevenuerManagerData::tryGet(header_text, &header_error_line);
+
+  if (!header.has_value()) {
+    error_line = header_error_line;
+    return false;
+  }
+
+  // Names are only known in full at the end, so records are collected aside.
+  ClientInterner clients;
+  std::string records;
+  BinaryWriter record_writer(records);
+  auto events_begin = in.offset();
+
+  while (true) {
+    auto events_end = in.offset();
+    auto line = in.next().value_or(std::string_view());
+
+    if (line.empty()) {
+      // A run only reads past an empty line if somebody is still in the club,
+      // records cannot hold that, so such text is rejected at the next event.
+      auto rest = in.next();
+
+      while (rest.has_value() && rest->empty()) {
+        rest = in.next();
+      }
+
+      if (rest.has_value() &&
+          clientsPresentAfter(*header, text.substr(events_begin, events_end - events_begin)))
+      {
+        error_line = *rest;
+        return false;
+      }
+      break;
+    }
+
+    auto event = InputEvent::tryGet(line);
+
+    if (!event.has_value()) {
+      error_line = line;
+      return false;
+    }
+
+    record_writer.fixed(static_cast<std::uint16_t>(event->time));
+    record_writer.fixed(static_cast<std::uint8_t>(event->type));
+    record_writer.varint(clients.intern(event->client_id));
+
+    if (event->type == InputEvent::Type::CLIENT_TAKE_TABLE) {
+      record_writer.varint(event->table_id);
+    }
+  }
+
+  binary.clear();
+
+  BinaryWriter writer(binary);
+
+  writer.bytes(BINARY_LOG_MAGIC);
+  writer.fixed(BINARY_LOG_VERSION);
+  writer.fixed(static_cast<std::uint32_t>(header->table_count));
+  writer.fixed(static_cast<std::uint16_t>(header->begin_time));
+  writer.fixed(static_cast<std::uint16_t>(header->end_time));
+  writer.fixed(static_cast<std::uint32_t>(header->cost_per_hour));
+
+  writer.varint(clients.size());
+
+  for (ClientHandle client = 0; client < clients.size(); ++client) {
+    writer.string(clients.name(client));
+  }
+
+  writer.bytes(records);
+
+  return true;
+}
+
+bool binaryLogToText(std::string_view binary, std::string& text)
+{
+  BinaryLogReader reader(binary);
+  auto header = reader.open();
+
+  if (!header.has_value()) {
+    return false;
+  }
+
+  text.clear();
+
+  appendNumber(text, header->table_count);
+  text += '\n';
+  appendClock(text, header->begin_time);
+  text += ' ';
+  appendClock(text, header->end_time);
+  text += '\n';
+  appendNumber(text, header->cost_per_hour);
+  text += '\n';
+
+  while (auto event = reader.next()) {
+    appendClock(text, event->time);
+    text += ' ';
+    appendNumber(text, static_cast<int>(event->type));
+    text += ' ';
+    text += event->client_id;
+
+    if (event->type == InputEvent::Type::CLIENT_TAKE_TABLE) {
+      text += ' ';
+      appendNumber(text, event->table_id + 1);
+    }
+    text += '\n';
+  }
+
+  return reader.good();
+}
+
+BinaryLogReader::BinaryLogReader(std::string_view data) noexcept :
+    reader(data)
+{}
+
+std::optional<RevenuerManagerData> BinaryLogReader::open()
+{
+  if (reader.bytes(BINARY_LOG_MAGIC.size()) != BINARY_LOG_MAGIC ||
+      reader.fixed<std::uint32_t>() != BINARY_LOG_VERSION)
+  {
+    return std::nullopt;
+  }
+
+  RevenuerManagerData header;
+
+  header.table_count = reader.fixed<std::uint32_t>();
+  header.begin_time = reader.fixed<std::uint16_t>();
+  header.end_time = reader.fixed<std::uint16_t>();
+  header.cost_per_hour = reader.fixed<std::uint32_t>();
+
+  auto client_count = reader.varint();
+
+  // The same limits as the text header and the names, at least a byte per name.
+  if (!reader.good() || header.table_count == 0 || header.cost_per_hour == 0 ||
+      !validClock(header.begin_time) || !validClock(header.end_time) ||
+      client_count > reader.remaining())
+  {
+    return std::nullopt;
+  }
+
+  names.reserve(client_count);
+
+  for (std::size_t i = 0; i < client_count; ++i) {
+    auto name = reader.string();
+
+    if (!reader.good() || !InputEvent::validClientId(name)) {
+      return std::nullopt;
+    }
+    names.push_back(name);
+  }
+
+  return header;
+}
+
+std::optional<InputEvent> BinaryLogReader::next() noexcept
+{
+  if (malformed || reader.remaining() == 0) {
+    return std::nullopt;
+  }
+
+  InputEvent event;
+
+  event.time = reader.fixed<std::uint16_t>();
+
+  auto type = reader.fixed<std::uint8_t>();
+  auto client = reader.varint();
+
+  event.type = static_cast<InputEvent::Type>(type);
+  event.table_id = 0;
+
+  if (event.type == InputEvent::Type::CLIENT_TAKE_TABLE) {
+    auto table = reader.varint();
+
+    event.table_id = static_cast<uint>(table);
+    malformed = table >= std::numeric_limits<uint>::max();
+  }
+
+  malformed = malformed || !reader.good() || !validClock(event.time) || type < 1 ||
+              type > 4 || client >= names.size();
+
+  if (malformed) {
+    return std::nullopt;
+  }
+
+  event.client_id = names[client];
+
+  return event;
+}
+
+bool BinaryLogReader::good() const noexcept
+{
+  return !malformed && reader.good();
+}
+
+bool processBinaryLog(
+    std::string_view data, OutputTarget output, RevenuerManagerOptions options,
+    std::string& error_line
+)
+{
+  BinaryLogReader reader(data);
+  auto header = reader.open();
+
+  error_line.clear();
+
+  if (!header.has_value()) {
+    return false;
+  }
+
+  RevenuerManager manager(*header, output, options);
+
+  while (auto event = reader.next()) {
+    if (!manager.feed(*event)) {
+      error_line = manager.errorLine();
+      manager.endRejected();
+      return false;
+    }
+  }
+
+  if (!reader.good()) {
+    manager.endRejected();
+    return false;
+  }
+
+  manager.finish();
+
+  return true;
+}
+
+} // namespace task
@@ -0,0 +1,41 @@
+#include <ClientInterner.hpp>
+
+namespace task {
+
+ClientHandle ClientInterner::intern(std::string_view name)
+{
+  auto it = handles.find(name);
+
+  if (it != handles.end()) {
+    return it->second;
+  }
+
+  auto handle = static_cast<ClientHandle>(names.size());
+
+  it = handles.emplace(std::string(name), handle).first;
+  names.push_back(it->first);
+
+  return handle;
+}
+
+ClientHandle ClientInterner::find(std::string_view name) const noexcept
+{
+  auto it = handles.find(name);
+
+  if (it == handles.end()) {
+    return NONE;
+  }
+  return it->second;
+}
+
+std::string_view ClientInterner::name(ClientHandle handle) const noexcept
+{
+  return names[handle];
+}
+
+std::size_t ClientInterner::size() const noexcept
+{
+  return names.size();
+}
+
+} // namespace task
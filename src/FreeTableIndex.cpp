@@ -0,0 +1,114 @@
+#include <FreeTableIndex.hpp>
+
+#include <bit>
+
+namespace task {
+
+FreeTableIndex::FreeTableIndex(std::size_t table_count) :
+    words((table_count + WORD_BITS - 1) / WORD_BITS, ~std::uint64_t{0}),
+    summary((words.size() + WORD_BITS - 1) / WORD_BITS, ~std::uint64_t{0}),
+    table_count(table_count),
+    free_count(table_count)
+{
+  if (table_count % WORD_BITS != 0) {
+    words.back() = (std::uint64_t{1} << (table_count % WORD_BITS)) - 1;
+  }
+
+  if (words.size() % WORD_BITS != 0) {
+    summary.back() = (std::uint64_t{1} << (words.size() % WORD_BITS)) - 1;
+  }
+}
+
+void FreeTableIndex::setFree(std::size_t table) noexcept
+{
+  auto word = table / WORD_BITS;
+  auto bit = std::uint64_t{1} << (table % WORD_BITS);
+
+  if ((words[word] & bit) != 0) {
+    return;
+  }
+
+  words[word] |= bit;
+  summary[word / WORD_BITS] |= std::uint64_t{1} << (word % WORD_BITS);
+  ++free_count;
+}
+
+void FreeTableIndex::setBusy(std::size_t table) noexcept
+{
+  auto word = table / WORD_BITS;
+  auto bit = std::uint64_t{1} << (table % WORD_BITS);
+
+  if ((words[word] & bit) == 0) {
+    return;
+  }
+
+  words[word] &= ~bit;
+
+  if (words[word] == 0) {
+    summary[word / WORD_BITS] &= ~(std::uint64_t{1} << (word % WORD_BITS));
+  }
+  --free_count;
+}
+
+bool FreeTableIndex::isFree(std::size_t table) const noexcept
+{
+  return (words[table / WORD_BITS] >> (table % WORD_BITS)) & 1;
+}
+
+std::size_t FreeTableIndex::count() const noexcept
+{
+  return free_count;
+}
+
+std::size_t FreeTableIndex::size() const noexcept
+{
+  return table_count;
+}
+
+std::size_t FreeTableIndex::first() const noexcept
+{
+  return next(0);
+}
+
+std::size_t FreeTableIndex::next(std::size_t from) const noexcept
+{
+  if (from >= table_count) {
+    return NONE;
+  }
+
+  auto word = from / WORD_BITS;
+  auto bits = words[word] & (~std::uint64_t{0} << (from % WORD_BITS));
+
+  if (bits == 0) {
+    word = nextWord(word + 1);
+
+    if (word == NONE) {
+      return NONE;
+    }
+    bits = words[word];
+  }
+
+  return word * WORD_BITS + std::countr_zero(bits);
+}
+
+// Index of the first word at or after `word` with a free table, NONE if none.
+std::size_t FreeTableIndex::nextWord(std::size_t word) const noexcept
+{
+  if (word >= words.size()) {
+    return NONE;
+  }
+
+  auto group = word / WORD_BITS;
+  auto bits = summary[group] & (~std::uint64_t{0} << (word % WORD_BITS));
+
+  while (bits == 0) {
+    if (++group == summary.size()) {
+      return NONE;
+    }
+    bits = summary[group];
+  }
+
+  return group * WORD_BITS + std::countr_zero(bits);
+}
+
+} // namespace task
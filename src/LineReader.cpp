@@ -0,0 +1,126 @@
+#include <LineReader.hpp>
+#include <base_parser/Scanner.hpp>
+
+#include <algorithm>
+
+namespace task {
+
+namespace {
+
+constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+std::uint64_t hashBytes(std::uint64_t hash, std::string_view bytes) noexcept
+{
+  for (char byte : bytes) {
+    hash = (hash ^ static_cast<unsigned char>(byte)) * FNV_PRIME;
+  }
+  return hash;
+}
+
+} // namespace
+
+LineReader::LineReader(std::istream& input) noexcept :
+    stream(&input),
+    hash(FNV_OFFSET_BASIS)
+{}
+
+LineReader::LineReader(std::string_view input) noexcept :
+    data(input),
+    hash(FNV_OFFSET_BASIS)
+{}
+
+std::optional<std::string_view> LineReader::next()
+{
+  if (stream != nullptr) {
+    if (!std::getline(*stream, buffer)) {
+      return std::nullopt;
+    }
+    // The last line need not end with a newline.
+    consumed += buffer.size() + (stream->eof() ? 0 : 1);
+
+    if (tracking) {
+      hash = hashBytes(hash, buffer);
+      hash = stream->eof() ? hash : hashBytes(hash, "\n");
+    }
+
+    return std::string_view(buffer);
+  }
+
+  if (pos >= data.size()) {
+    return std::nullopt;
+  }
+
+  auto line_end = base_parser::find(data, '\n', pos);
+  auto line = data.substr(pos, line_end - pos);
+  pos = line_end + 1;
+
+  return line;
+}
+
+bool LineReader::inMemory() const noexcept
+{
+  return stream == nullptr;
+}
+
+std::size_t LineReader::offset() const noexcept
+{
+  if (stream != nullptr) {
+    return consumed;
+  }
+  return std::min(pos, data.size());
+}
+
+bool LineReader::skip(std::size_t count)
+{
+  if (count == 0) {
+    return true;
+  }
+
+  if (stream != nullptr) {
+    constexpr std::size_t CHUNK_SIZE = 4096;
+    auto left = count;
+    char last = '\0';
+
+    buffer.resize(CHUNK_SIZE);
+
+    while (left != 0) {
+      stream->read(buffer.data(), static_cast<std::streamsize>(std::min(left, CHUNK_SIZE)));
+
+      auto read = static_cast<std::size_t>(stream->gcount());
+
+      if (read == 0) {
+        return false;
+      }
+      hash = hashBytes(hash, std::string_view(buffer.data(), read));
+      consumed += read;
+      left -= read;
+      last = buffer[read - 1];
+    }
+
+    return last == '\n';
+  }
+
+  if (count > data.size() - offset() || data[offset() + count - 1] != '\n') {
+    return false;
+  }
+  pos = offset() + count;
+
+  return true;
+}
+
+std::uint64_t LineReader::digest()
+{
+  if (stream == nullptr) {
+    hash = hashBytes(hash, data.substr(hashed, offset() - hashed));
+    hashed = offset();
+  }
+  return hash;
+}
+
+void LineReader::trackDigest() noexcept
+{
+  tracking = true;
+}
+
+} // namespace task
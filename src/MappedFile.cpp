@@ -0,0 +1,72 @@
+#include <MappedFile.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace task {
+
+MappedFile::MappedFile(const char* path) noexcept
+{
+  int fd = ::open(path, O_RDONLY);
+
+  if (fd == -1) {
+    return;
+  }
+
+  struct stat info;
+
+  if (::fstat(fd, &info) == -1 || !S_ISREG(info.st_mode)) {
+    ::close(fd);
+    return;
+  }
+
+  size = static_cast<std::size_t>(info.st_size);
+
+  if (size > 0) {
+    void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (address == MAP_FAILED) {
+      size = 0;
+      ::close(fd);
+      return;
+    }
+
+    ::madvise(address, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(address);
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  ::close(fd);
+  mapped = true;
+}
+
+MappedFile::~MappedFile()
+{
+  if (data != nullptr) {
+    ::munmap(const_cast<char*>(data), size);
+  }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    data(other.data),
+    size(other.size),
+    mapped(other.mapped)
+{
+  other.data = nullptr;
+  other.size = 0;
+  other.mapped = false;
+}
+
+MappedFile::operator bool() const noexcept
+{
+  return mapped;
+}
+
+std::string_view MappedFile::view() const noexcept
+{
+  return std::string_view(data, size);
+}
+
+} // namespace task
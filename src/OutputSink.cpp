@@ -0,0 +1,101 @@
+#include <OutputSink.hpp>
+
+#include <cerrno>
+#include <unistd.h>
+
+namespace task {
+
+OutputSink::OutputSink(OutputTarget target, FlushPolicy policy, std::size_t threshold) noexcept
+    :
+    target(target),
+    policy(policy),
+    threshold(threshold)
+{}
+
+std::string& OutputSink::buffer() noexcept
+{
+  return data;
+}
+
+void OutputSink::commit()
+{
+  switch (policy) {
+  case FlushPolicy::END: {
+    break;
+  }
+  case FlushPolicy::THRESHOLD: {
+    if (data.size() >= threshold) {
+      flush();
+    }
+    break;
+  }
+  case FlushPolicy::LINE: {
+    flush();
+    break;
+  }
+  }
+}
+
+void OutputSink::flush()
+{
+  if (data.empty()) {
+    return;
+  }
+
+  ++write_count;
+  written_size += data.size();
+
+  if (target.stream != nullptr) {
+    target.stream->write(data.data(), data.size());
+
+    if (policy == FlushPolicy::LINE) {
+      target.stream->flush();
+    }
+  } else if (target.text != nullptr) {
+    *target.text += data;
+  } else {
+    writeDescriptor();
+  }
+
+  data.clear();
+}
+
+void OutputSink::discard() noexcept
+{
+  data.clear();
+}
+
+std::size_t OutputSink::writeCount() const noexcept
+{
+  return write_count;
+}
+
+std::size_t OutputSink::writtenSize() const noexcept
+{
+  return written_size;
+}
+
+bool OutputSink::good() const noexcept
+{
+  return !failed;
+}
+
+void OutputSink::writeDescriptor()
+{
+  const char* begin = data.data();
+  std::size_t left = data.size();
+
+  // write() may take only part of the buffer, e.g. on a pipe.
+  while (left > 0 && !failed) {
+    auto written = ::write(target.fd, begin, left);
+
+    if (written < 0) {
+      failed = errno != EINTR;
+      continue;
+    }
+    begin += written;
+    left -= static_cast<std::size_t>(written);
+  }
+}
+
+} // namespace task
@@ -1,46 +1,57 @@
+#include <Format.hpp>
 #include <RevenuerManager.hpp>
-#include <types/RevenuerManagerData.hpp>
 
-#include <iomanip>
+#include <algorithm>
 
 namespace {
 
-std::string formatTime(int time)
+task::OutputSink::FlushPolicy flushPolicy(const task::RevenuerManagerOptions& options)
 {
-  std::stringstream stream;
-  stream << std::setfill('0');
+  using Policy = task::OutputSink::FlushPolicy;
 
-  auto hour = time / 60;
-  auto minute = time % 60;
-
-  stream << std::setw(2) << hour;
-  stream << ":";
-  stream << std::setw(2) << minute;
-
-  return stream.str();
+  if (!options.streaming) {
+    return Policy::END;
+  }
+  return options.flush_each_line ? Policy::LINE : Policy::THRESHOLD;
 }
 
-std::string to_string(const task::InputEvent& event)
+void appendEvent(std::string& out, const task::InputEvent& event)
 {
   using namespace task;
-  std::stringstream stream;
 
-  stream << formatTime(event.time) << ' ' << static_cast<int>(event.type) << ' ';
+  // Event times are within a day and types are single digits, so everything up to
+  // the client ID has a fixed width and is written in one go.
+  constexpr std::size_t PREFIX_WIDTH = CLOCK_WIDTH + 3;
 
-  switch (event.type) {
-  case InputEvent::Type::CLIENT_ARRIVE:
-  case InputEvent::Type::CLIENT_WAIT:
-  case InputEvent::Type::CLIENT_LEAVE: {
-    stream << event.client_id;
-    break;
-  }
-  case InputEvent::Type::CLIENT_TAKE_TABLE: {
-    stream << event.client_id << ' ' << event.table_id + 1;
-    break;
-  }
+  auto clock = clockOfDay(event.time);
+  auto pos = out.size();
+
+  out.resize(pos + PREFIX_WIDTH + event.client_id.size());
+
+  auto* data = out.data() + pos;
+
+  clock.copy(data, CLOCK_WIDTH);
+  data[CLOCK_WIDTH] = ' ';
+  data[CLOCK_WIDTH + 1] = static_cast<char>('0' + static_cast<int>(event.type));
+  data[CLOCK_WIDTH + 2] = ' ';
+  event.client_id.copy(data + PREFIX_WIDTH, event.client_id.size());
+
+  if (event.type == InputEvent::Type::CLIENT_TAKE_TABLE) {
+    out += ' ';
+    appendNumber(out, event.table_id + 1);
   }
+}
 
-  return stream.str();
+// The 8 bytes of the name from `offset` on, zero past its end, read as a big-endian
+// number, so keys order like the names unless they are equal.
+std::uint64_t sortKey(std::string_view name, std::size_t offset) noexcept
+{
+  std::uint64_t key = 0;
+
+  for (std::size_t i = offset; i < offset + 8; ++i) {
+    key = (key << 8) | (i < name.size() ? static_cast<unsigned char>(name[i]) : 0);
+  }
+  return key;
 }
 
 } // namespace
@@ -48,143 +59,440 @@ std::string to_string(const task::InputEvent& event)
 namespace task {
 
 RevenuerManager::RevenuerManager(
-    std::istream& input_data, std::ostream& output_data
+    std::istream& input_data, OutputTarget output_data, RevenuerManagerOptions options
+) noexcept :
+    options(options),
+    in(input_data),
+    out(output_data, flushPolicy(options), options.stream_buffer_size),
+    prepared(out.buffer())
+{
+  // A stream is gone once read, so the digest of the input is kept up as it goes.
+  if (options.checkpoint_every != 0) {
+    in.trackDigest();
+  }
+}
+
+RevenuerManager::RevenuerManager(
+    std::string_view input_data, OutputTarget output_data,
+    RevenuerManagerOptions options
 ) noexcept :
+    options(options),
     in(input_data),
-    out(output_data)
+    out(output_data, flushPolicy(options), options.stream_buffer_size),
+    prepared(out.buffer())
 {}
 
+RevenuerManager::RevenuerManager(
+    const RevenuerManagerData& data, OutputTarget output_data,
+    RevenuerManagerOptions options
+) :
+    options(options),
+    in(std::string_view()),
+    out(output_data, flushPolicy(options), options.stream_buffer_size),
+    prepared(out.buffer())
+{
+  setUp(data);
+  writeOpeningTime();
+}
+
 void RevenuerManager::process()
 {
-  initialize();
+  if (!tryProcess()) {
+    throw std::runtime_error(error_line);
+  }
+}
+
+bool RevenuerManager::tryProcess()
+{
+  if (!restored && !initialize()) {
+    return false;
+  }
+
+  bool accepted = options.pipelined && options.checkpoint_every == 0 && in.inMemory()
+                      ? processEventsPipelined()
+                      : processEvents();
+
+  if (!accepted) {
+    endRejected();
+    return false;
+  }
+
+  finalize();
+
+  return true;
+}
+
+const std::string& RevenuerManager::errorLine() const noexcept
+{
+  return error_line;
+}
 
+const TableStore& RevenuerManager::tables() const noexcept
+{
+  return table_store;
+}
+
+const FreeTableIndex& RevenuerManager::freeTables() const noexcept
+{
+  return free_tables;
+}
+
+std::size_t RevenuerManager::outputWriteCount() const noexcept
+{
+  return out.writeCount();
+}
+
+bool RevenuerManager::feed(const InputEvent& event)
+{
+  if (processInputEvent(event) != Failure::NONE) {
+    error_line.clear();
+    appendEvent(error_line, event);
+    return false;
+  }
+
+  appendEvent(prepared, event);
+  prepared += '\n';
+  out.commit();
+
+  return processPending();
+}
+
+void RevenuerManager::finish()
+{
+  if (!present_clients.empty()) {
+    kickOutLeftClients();
+    processPending();
+  }
+
+  finalize();
+}
+
+void RevenuerManager::endRejected()
+{
+  // Buffered output only ever holds a complete transcript.
+  if (options.streaming) {
+    out.flush();
+  } else {
+    out.discard();
+  }
+}
+
+int RevenuerManager::currentTime() const noexcept
+{
+  return last_time_event;
+}
+
+std::size_t RevenuerManager::clientCount() const noexcept
+{
+  return present_clients.size();
+}
+
+std::size_t RevenuerManager::queueLength() const noexcept
+{
+  return client_queue.size();
+}
+
+std::optional<TableID> RevenuerManager::clientTable(std::string_view client_id) const noexcept
+{
+  auto client = findPresentClient(client_id);
+
+  if (client == ClientInterner::NONE || client_table[client] == NO_TABLE) {
+    return std::nullopt;
+  }
+  return client_table[client];
+}
+
+std::optional<std::string_view>
+RevenuerManager::tableOccupant(TableID table_id) const noexcept
+{
+  if (!validTable(table_id) || table_store.busySince(table_id) == TableStore::FREE) {
+    return std::nullopt;
+  }
+  return clients.name(table_client[table_id]);
+}
+
+std::optional<int> RevenuerManager::busySince(TableID table_id) const noexcept
+{
+  if (!validTable(table_id) || table_store.busySince(table_id) == TableStore::FREE) {
+    return std::nullopt;
+  }
+  return table_store.busySince(table_id);
+}
+
+TableStatistic
+RevenuerManager::accruedStatistic(TableID table_id, int current_time) const noexcept
+{
+  if (!validTable(table_id)) {
+    return {};
+  }
+
+  auto time = std::max(current_time, table_store.busySince(table_id));
+
+  return table_store.accrued(table_id, time, cost_per_hour);
+}
+
+bool RevenuerManager::validTable(TableID table_id) const noexcept
+{
+  return table_id >= 0 && static_cast<std::size_t>(table_id) < table_store.size();
+}
+
+bool RevenuerManager::processEvents()
+{
   while (true) {
-    if (!generated_event_queue.empty()) {
-      processGeneratedEvent(generated_event_queue.front());
-      generated_event_queue.pop();
-      continue;
-    }
+    stage_sampler.begin(run_stats);
 
-    if (deferred_event.has_value()) {
-      auto event = std::move(deferred_event.value());
-      deferred_event.reset();
-      try {
-        processInputEvent(event);
-      } catch (...) {
-        throw std::runtime_error(to_string(event));
-      }
-      continue;
+    if (!processPending()) {
+      return false;
     }
+    stage_sampler.lap(run_stats, Stage::GENERATED_EVENT);
 
-    std::string event_str;
+    if (options.checkpoint_every != 0 && !options.checkpoint_path.empty() &&
+        events_since_checkpoint >= options.checkpoint_every)
+    {
+      writeCheckpointFile();
+      events_since_checkpoint = 0;
+    }
 
-    std::getline(in, event_str);
+    auto event_str = in.next().value_or(std::string_view());
+    stage_sampler.lap(run_stats, Stage::READ);
 
     if (event_str.empty()) {
-      if (client2table.size()) {
+      if (!present_clients.empty()) {
         kickOutLeftClients();
         continue;
       }
-      break;
+      return true;
     }
 
-    prepared << event_str << std::endl;
-
-    auto event = InputEvent::get(event_str);
+    auto event = InputEvent::tryGet(event_str);
+    stage_sampler.lap(run_stats, Stage::PARSE);
 
-    try {
-      processInputEvent(event);
-    } catch (...) {
-      throw std::runtime_error(event_str);
+    if (!event.has_value() || processInputEvent(*event) != Failure::NONE) {
+      error_line = event_str;
+      return false;
     }
+    stage_sampler.lap(run_stats, Stage::INPUT_EVENT);
+
+    // Echoed only once the event is accepted, so a streamed transcript never
+    // contains the line that stopped processing.
+    writeLine(TranscriptLine{.kind = TranscriptLine::Kind::INPUT, .text = event_str});
+    stage_sampler.lap(run_stats, Stage::OUTPUT);
+
+    ++events_since_checkpoint;
   }
+}
 
-  finalize();
+bool RevenuerManager::processPending()
+{
+  raisePeak(run_stats.peak_pending_events, generated_event_queue.size());
+
+  while (true) {
+    if (!generated_event_queue.empty()) {
+      processGeneratedEvent(generated_event_queue.front());
+      generated_event_queue.pop();
+      continue;
+    }
+
+    if (!deferred_event.has_value()) {
+      return true;
+    }
+
+    // The event came past closing time, the clients still in the club leave
+    // before it is run.
+    if (!present_clients.empty()) {
+      kickOutLeftClients();
+    }
+
+    auto event = *deferred_event;
+    deferred_event.reset();
+
+    if (processInputEvent(event) != Failure::NONE) {
+      error_line.clear();
+      appendEvent(error_line, event);
+      return false;
+    }
+  }
 }
 
-void RevenuerManager::initialize()
+bool RevenuerManager::initialize()
 {
   std::string init_data;
-  std::string line;
 
   init_data.reserve(128);
 
-  std::getline(in, line);
+  for (int i = 0; i < 3; ++i) {
+    auto line = in.next();
 
-  if (!in.fail()) {
-    init_data += line + "\n";
-    std::getline(in, line);
+    if (!line.has_value()) {
+      break;
+    }
+    init_data += *line;
+    init_data += '\n';
   }
 
-  if (!in.fail()) {
-    init_data += line + "\n";
-    std::getline(in, line);
-  }
+  std::string_view data_error_line;
+  auto parsed = RevenuerManagerData::tryGet(init_data, &data_error_line);
 
-  if (!in.fail()) {
-    init_data += line + "\n";
+  if (!parsed.has_value()) {
+    error_line = data_error_line;
+    return false;
   }
 
-  auto data = RevenuerManagerData::get(init_data);
+  setUp(*parsed);
+  writeOpeningTime();
+
+  return true;
+}
 
-  free_table_count = data.table_count;
+void RevenuerManager::setUp(const RevenuerManagerData& data)
+{
+  free_tables = FreeTableIndex(data.table_count);
   begin_time = data.begin_time;
   end_time = data.end_time;
   cost_per_hour = data.cost_per_hour;
 
-  table_staticstic_list.resize(data.table_count);
-  table_time_busy.resize(data.table_count, -1);
+  table_store = TableStore(data.table_count);
+  table_client.resize(data.table_count, ClientInterner::NONE);
+  // A client only waits while every table is busy, so there are never more of
+  // them than tables.
+  client_queue = WaitQueue(data.table_count);
 
-  prepared << formatTime(begin_time) << '\n';
+  if (options.streaming) {
+    prepared.reserve(options.stream_buffer_size);
+  }
+}
+
+void RevenuerManager::writeOpeningTime()
+{
+  appendClock(prepared, begin_time);
+  prepared += '\n';
+  out.commit();
 }
 
 void RevenuerManager::finalize()
 {
-  out << prepared.str();
-  out << formatTime(end_time) << '\n';
+  [[maybe_unused]] std::uint64_t start = 0;
 
-  for (std::size_t i = 0; i < table_staticstic_list.size(); ++i) {
-    out << i + 1 << ' ' << table_staticstic_list[i].revenue << ' '
-        << formatTime(table_staticstic_list[i].used_time) << '\n';
+  if constexpr (STATS_ENABLED) {
+    start = readTicks();
   }
+
+  appendClock(prepared, end_time);
+  prepared += '\n';
+  out.commit();
+
+  for (std::size_t i = 0; i < table_store.size(); ++i) {
+    auto statistic = table_store.statistic(i);
+
+    appendNumber(prepared, i + 1);
+    prepared += ' ';
+    appendNumber(prepared, statistic.revenue);
+    prepared += ' ';
+    appendClock(prepared, statistic.used_time);
+    prepared += '\n';
+    out.commit();
+  }
+
+  out.flush();
+
+  if constexpr (STATS_ENABLED) {
+    run_stats.finalize_ticks += readTicks() - start;
+  }
+}
+
+void RevenuerManager::writeLine(const TranscriptLine& line)
+{
+  if (transcript != nullptr) {
+    transcript->push(line);
+    return;
+  }
+
+  appendLine(prepared, line);
+  out.commit();
+}
+
+void RevenuerManager::appendLine(std::string& out, const TranscriptLine& line)
+{
+  if (line.kind == TranscriptLine::Kind::INPUT) {
+    out += line.text;
+    out += '\n';
+    return;
+  }
+
+  appendClock(out, line.time);
+  out += ' ';
+  appendNumber(out, static_cast<int>(line.type));
+  out += ' ';
+  out += line.text;
+
+  if (line.type == GeneratedEvent::Type::CLIENT_TAKE_TABLE) {
+    out += ' ';
+    appendNumber(out, line.table_id + 1);
+  }
+  out += '\n';
 }
 
 void RevenuerManager::processGeneratedEvent(const GeneratedEvent& event)
 {
-  prepared << formatTime(event.time) << ' ' << static_cast<int>(event.type) << ' ';
+  TranscriptLine line{
+      .kind = TranscriptLine::Kind::GENERATED,
+      .time = event.time,
+      .type = event.type,
+      .table_id = event.table_id};
+
+  countIn(
+      run_stats.generated_events,
+      static_cast<std::size_t>(event.type) -
+          static_cast<std::size_t>(GeneratedEvent::Type::CLIENT_LEAVE)
+  );
+
   switch (event.type) {
   case GeneratedEvent::Type::CLIENT_LEAVE: {
-    prepared << event.client_it->first << std::endl;
-    removeClient(event.time, event.client_it);
+    line.text = clients.name(event.client);
+    removeClient(event.time, event.client);
     break;
   }
   case GeneratedEvent::Type::CLIENT_TAKE_TABLE: {
-    prepared << event.client_it->first << " " << event.table_id + 1 << std::endl;
-    setClientToTable(event.time, event.client_it, event.table_id);
+    line.text = clients.name(event.client);
+    setClientToTable(event.time, event.client, event.table_id);
     break;
   }
   case GeneratedEvent::Type::ERROR: {
-    prepared << event.error_message << std::endl;
+    line.text = GeneratedEvent::ERROR_MESSAGES[static_cast<std::size_t>(event.error)];
+    countIn(run_stats.errors, static_cast<std::size_t>(event.error));
     break;
   }
   }
+
+  writeLine(line);
 }
 
-void RevenuerManager::processInputEvent(const InputEvent& event)
+RevenuerManager::Failure RevenuerManager::processInputEvent(const InputEvent& event)
 {
-  if (event.time == end_time && event.type == InputEvent::Type::CLIENT_LEAVE) {
-  } else if (event.time >= end_time && !client2table.empty()) {
-    deferred_event = event;
+  if (event.time < last_time_event) {
+    return Failure::INVALID_EVENT_ORDER;
+  }
 
-    kickOutLeftClients();
+  bool deferred = event.time >= end_time && !present_clients.empty() &&
+                  !(event.time == end_time && event.type == InputEvent::Type::CLIENT_LEAVE);
 
-    return;
+  // Checked before anything changes, so a rejected event leaves the state as it was.
+  // A deferred event finds nobody in the club, who is answered ClientUnknown.
+  if (!deferred && event.type == InputEvent::Type::CLIENT_TAKE_TABLE &&
+      event.table_id >= table_store.size() &&
+      findPresentClient(event.client_id) != ClientInterner::NONE)
+  {
+    return Failure::NON_EXISTENT_TABLE;
   }
+  last_time_event = event.time;
 
-  if (event.time < last_time_event) {
-    throw error<std::runtime_error>("Invalid event order");
+  if (deferred) {
+    deferred_event = event;
+
+    return Failure::NONE;
   }
-  last_time_event = event.time;
+
+  countIn(run_stats.input_events, static_cast<std::size_t>(event.type) - 1);
 
   switch (event.type) {
   case InputEvent::Type::CLIENT_ARRIVE: {
@@ -204,9 +512,11 @@ void RevenuerManager::processInputEvent(const InputEvent& event)
     break;
   }
   default: {
-    throw std::runtime_error("Unknown event type");
+    return Failure::UNKNOWN_EVENT_TYPE;
   }
   }
+
+  return Failure::NONE;
 }
 
 void RevenuerManager::processClientArrive(const InputEvent& event)
@@ -215,148 +525,261 @@ void RevenuerManager::processClientArrive(const InputEvent& event)
     generated_event_queue.push(GeneratedEvent{
         .time = event.time,
         .type = GeneratedEvent::Type::ERROR,
-        .error_message = "NotOpenYet"});
+        .error = GeneratedEvent::Error::NOT_OPEN_YET});
     return;
   }
 
-  auto it = client2table.find(event.client_id);
+  auto client = clients.intern(event.client_id);
+
+  if (client >= client_table.size()) {
+    client_table.resize(client + 1, NOT_PRESENT);
+    client_wait_slot.resize(client + 1, WaitQueue::NONE);
+    present_slot.resize(client + 1);
+  }
 
-  if (it != client2table.end()) {
+  if (client_table[client] != NOT_PRESENT) {
     generated_event_queue.push(GeneratedEvent{
         .time = event.time,
         .type = GeneratedEvent::Type::ERROR,
-        .error_message = "YouShallNotPass"});
+        .error = GeneratedEvent::Error::YOU_SHALL_NOT_PASS});
     return;
   }
 
-  client2table[event.client_id] = -1;
+  client_table[client] = NO_TABLE;
+  addPresent(client);
+
+  raisePeak(run_stats.peak_clients, present_clients.size());
 }
 
 void RevenuerManager::processClientTakeTable(const InputEvent& event)
 {
-  auto it = client2table.find(event.client_id);
+  auto client = findPresentClient(event.client_id);
 
-  if (it == client2table.end()) {
+  if (client == ClientInterner::NONE) {
     generated_event_queue.push(GeneratedEvent{
         .time = event.time,
         .type = GeneratedEvent::Type::ERROR,
-        .error_message = "ClientUnknown"});
+        .error = GeneratedEvent::Error::CLIENT_UNKNOWN});
     return;
   }
 
-  if (event.table_id >= table_time_busy.size()) {
-    throw error<std::range_error>("The client attempted to sit on a non-existent table");
-  }
-
-  if (table_time_busy[event.table_id] != -1) {
+  if (table_store.busySince(event.table_id) != TableStore::FREE) {
     generated_event_queue.push(GeneratedEvent{
         .time = event.time,
         .type = GeneratedEvent::Type::ERROR,
-        .error_message = "PlaceIsBusy"});
+        .error = GeneratedEvent::Error::PLACE_IS_BUSY});
     return;
   }
 
-  setClientToTable(event.time, it, event.table_id);
+  setClientToTable(event.time, client, event.table_id);
 }
 
 void RevenuerManager::processClientWait(const InputEvent& event)
 {
-  auto it = client2table.find(event.client_id);
+  auto client = findPresentClient(event.client_id);
 
-  if (it == client2table.end()) {
+  if (client == ClientInterner::NONE) {
     generated_event_queue.push(GeneratedEvent{
         .time = event.time,
         .type = GeneratedEvent::Type::ERROR,
-        .error_message = "ClientUnknown"});
+        .error = GeneratedEvent::Error::CLIENT_UNKNOWN});
     return;
   }
 
-  if (free_table_count > 0) {
+  if (free_tables.count() > 0) {
+    if (options.auto_assign && client_table[client] == NO_TABLE) {
+      generated_event_queue.push(GeneratedEvent{
+          .time = event.time,
+          .type = GeneratedEvent::Type::CLIENT_TAKE_TABLE,
+          .client = client,
+          .table_id = static_cast<int>(free_tables.first())});
+      return;
+    }
+
     generated_event_queue.push(GeneratedEvent{
         .time = event.time,
         .type = GeneratedEvent::Type::ERROR,
-        .error_message = "ICanWaitNoLonger!"});
+        .error = GeneratedEvent::Error::I_CAN_WAIT_NO_LONGER});
+    return;
+  }
+
+  if (client_wait_slot[client] != WaitQueue::NONE) {
     return;
   }
 
-  if (client_queue.size() == table_time_busy.size()) {
+  if (client_queue.full()) {
     generated_event_queue.push(GeneratedEvent{
-        .time = event.time, .type = GeneratedEvent::Type::CLIENT_LEAVE, .client_it = it});
+        .time = event.time, .type = GeneratedEvent::Type::CLIENT_LEAVE, .client = client});
     return;
   }
 
-  client_queue.push(std::move(event.client_id));
+  client_wait_slot[client] = client_queue.push(client);
+
+  raisePeak(run_stats.peak_wait_queue, client_queue.size());
 }
 
 void RevenuerManager::processClientLeave(const InputEvent& event)
 {
-  auto it = client2table.find(event.client_id);
+  auto client = findPresentClient(event.client_id);
 
-  if (it == client2table.end()) {
+  if (client == ClientInterner::NONE) {
     generated_event_queue.push(GeneratedEvent{
         .time = event.time,
         .type = GeneratedEvent::Type::ERROR,
-        .error_message = "ClientUnknown"});
+        .error = GeneratedEvent::Error::CLIENT_UNKNOWN});
     return;
   }
 
-  if (it->second != -1 && !client_queue.empty()) {
+  removeFromQueue(client);
+
+  if (client_table[client] != NO_TABLE && !client_queue.empty()) {
+    auto next_client = client_queue.front();
+
     generated_event_queue.push(GeneratedEvent{
         .time = event.time,
         .type = GeneratedEvent::Type::CLIENT_TAKE_TABLE,
-        .client_it = client2table.find(client_queue.front()),
-        .table_id = it->second});
-    client_queue.pop();
+        .client = next_client,
+        .table_id = client_table[client]});
+    removeFromQueue(next_client);
   }
 
-  removeClient(event.time, it);
+  removeClient(event.time, client);
+}
+
+ClientHandle RevenuerManager::findPresentClient(std::string_view client_id) const noexcept
+{
+  auto client = clients.find(client_id);
+
+  if (client == ClientInterner::NONE || client_table[client] == NOT_PRESENT) {
+    return ClientInterner::NONE;
+  }
+  return client;
 }
 
 void RevenuerManager::setClientToTable(
-    int current_time, std::map<ClientID, TableID>::iterator it, uint table_id
+    int current_time, ClientHandle client, uint table_id
 )
 {
-  if (it->second != -1) {
-    unsetClientFromTable(current_time, it);
+  removeFromQueue(client);
+
+  if (client_table[client] != NO_TABLE) {
+    unsetClientFromTable(current_time, client);
   }
-  table_time_busy[table_id] = current_time;
-  it->second = table_id;
+  table_store.occupy(table_id, current_time);
+  table_client[table_id] = client;
+  client_table[client] = table_id;
 
-  --free_table_count;
+  free_tables.setBusy(table_id);
 }
 
-void RevenuerManager::unsetClientFromTable(
-    int current_time, std::map<ClientID, TableID>::iterator it
-)
+void RevenuerManager::unsetClientFromTable(int current_time, ClientHandle client)
 {
-  if (it->second == -1) {
+  auto table_id = client_table[client];
+
+  if (table_id == NO_TABLE) {
     return;
   }
-  auto passed_time = current_time - table_time_busy[it->second];
-  auto hours_passed = (passed_time / 60) + ((passed_time % 60 == 0) ? 0 : 1);
+  table_store.release(table_id, current_time, cost_per_hour);
+  free_tables.setFree(table_id);
 
-  table_staticstic_list[it->second].revenue += hours_passed * cost_per_hour;
-  table_staticstic_list[it->second].used_time += passed_time;
+  table_client[table_id] = ClientInterner::NONE;
+  client_table[client] = NO_TABLE;
+}
 
-  ++free_table_count;
+void RevenuerManager::removeClient(int current_time, ClientHandle client)
+{
+  removeFromQueue(client);
+  unsetClientFromTable(current_time, client);
 
-  table_time_busy[it->second] = -1;
+  client_table[client] = NOT_PRESENT;
+  removePresent(client);
 }
 
-void RevenuerManager::removeClient(
-    int current_time, std::map<ClientID, TableID>::iterator it
-)
+void RevenuerManager::addPresent(ClientHandle client)
 {
-  unsetClientFromTable(current_time, it);
+  present_slot[client] = present_clients.size();
+  present_clients.push_back(client);
+}
+
+void RevenuerManager::removePresent(ClientHandle client) noexcept
+{
+  // The last client takes the place of the one who left.
+  auto last = present_clients.back();
+
+  present_clients[present_slot[client]] = last;
+  present_slot[last] = present_slot[client];
+  present_clients.pop_back();
+}
+
+void RevenuerManager::removeFromQueue(ClientHandle client) noexcept
+{
+  if (client_wait_slot[client] == WaitQueue::NONE) {
+    return;
+  }
 
-  client2table.erase(it);
+  client_queue.remove(client_wait_slot[client]);
+  client_wait_slot[client] = WaitQueue::NONE;
 }
 
 void RevenuerManager::kickOutLeftClients()
 {
-  for (auto it = client2table.begin(); it != client2table.end(); ++it) {
-    generated_event_queue.push(GeneratedEvent{
-        .time = end_time, .type = GeneratedEvent::Type::CLIENT_LEAVE, .client_it = it});
+  // Everybody leaves at closing time, so all sessions are settled in one pass over
+  // the tables and the state of the clients is released in one pass over those in
+  // the club, instead of a generated event per client.
+  table_store.releaseAll(end_time, cost_per_hour);
+  client_queue.clear();
+
+  leaving_clients.clear();
+
+  for (auto client : present_clients) {
+    auto table_id = client_table[client];
+
+    if (table_id != NO_TABLE) {
+      free_tables.setFree(table_id);
+      table_client[table_id] = ClientInterner::NONE;
+    }
+    client_table[client] = NOT_PRESENT;
+    client_wait_slot[client] = WaitQueue::NONE;
+
+    leaving_clients.push_back(LeavingClient{.name = clients.name(client)});
+  }
+
+  present_clients.clear();
+
+  if (leaving_clients.empty()) {
+    return;
+  }
+
+  // Clients leave in the order of their names.
+  auto first = leaving_clients.front().name;
+  auto common_end = first.end();
+
+  for (auto& leaving : leaving_clients) {
+    common_end =
+        std::mismatch(first.begin(), common_end, leaving.name.begin(), leaving.name.end())
+            .first;
+  }
+
+  auto common_prefix = static_cast<std::size_t>(common_end - first.begin());
+
+  for (auto& leaving : leaving_clients) {
+    leaving.key = sortKey(leaving.name, common_prefix);
+  }
+
+  std::sort(
+      leaving_clients.begin(), leaving_clients.end(),
+      [](const LeavingClient& lhs, const LeavingClient& rhs) {
+        return lhs.key != rhs.key ? lhs.key < rhs.key : lhs.name < rhs.name;
+      }
+  );
+
+  for (auto& leaving : leaving_clients) {
+    countIn(run_stats.generated_events, 0);
+    writeLine(TranscriptLine{
+        .kind = TranscriptLine::Kind::GENERATED,
+        .text = leaving.name,
+        .time = end_time,
+        .type = GeneratedEvent::Type::CLIENT_LEAVE});
   }
 }
 
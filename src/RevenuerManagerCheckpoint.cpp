@@ -0,0 +1,252 @@
+#include <BinaryIO.hpp>
+#include <Format.hpp>
+#include <RevenuerManager.hpp>
+#include <log.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+namespace task {
+
+namespace {
+
+// Layout, little-endian:
+//   magic, version
+//   header: table count, opening time, closing time, cost per hour
+//   input offset, digest of the input up to it, output offset, time of the last
+//   event
+//   per table: revenue, used time, busy since (-1 if free), client (NONE if free)
+//   varint client count, per client in handle order: name, table
+//   varint queue length, waiting handles front first
+//   varint pending event count, always zero: checkpoints are taken between input
+//   lines, once every generated event has run
+constexpr std::string_view CHECKPOINT_MAGIC = "GRCP";
+constexpr std::uint32_t CHECKPOINT_VERSION = 2;
+constexpr std::size_t TABLE_RECORD_SIZE = 16;
+
+} // namespace
+
+void RevenuerManager::checkpoint(std::string& data)
+{
+  if (options.streaming) {
+    out.flush();
+  }
+
+  data.clear();
+
+  BinaryWriter writer(data);
+
+  writer.bytes(CHECKPOINT_MAGIC);
+  writer.fixed(CHECKPOINT_VERSION);
+
+  writer.fixed(static_cast<std::uint32_t>(table_store.size()));
+  writer.fixed(static_cast<std::int32_t>(begin_time));
+  writer.fixed(static_cast<std::int32_t>(end_time));
+  writer.fixed(static_cast<std::uint32_t>(cost_per_hour));
+
+  writer.fixed(static_cast<std::uint64_t>(in.offset()));
+  writer.fixed(in.digest());
+  writer.fixed(static_cast<std::uint64_t>(outputOffset()));
+  writer.fixed(static_cast<std::int32_t>(last_time_event));
+
+  for (std::size_t table = 0; table < table_store.size(); ++table) {
+    auto statistic = table_store.statistic(table);
+
+    writer.fixed(static_cast<std::uint32_t>(statistic.revenue));
+    writer.fixed(static_cast<std::uint32_t>(statistic.used_time));
+    writer.fixed(static_cast<std::int32_t>(table_store.busySince(table)));
+    writer.fixed(table_client[table]);
+  }
+
+  writer.varint(client_table.size());
+
+  for (ClientHandle client = 0; client < client_table.size(); ++client) {
+    writer.string(clients.name(client));
+    writer.fixed(static_cast<std::int32_t>(client_table[client]));
+  }
+
+  writer.varint(client_queue.size());
+  client_queue.forEach([&writer](ClientHandle client) { writer.varint(client); });
+
+  writer.varint(generated_event_queue.size());
+}
+
+bool RevenuerManager::restore(std::string_view data)
+{
+  BinaryReader reader(data);
+
+  if (reader.bytes(CHECKPOINT_MAGIC.size()) != CHECKPOINT_MAGIC ||
+      reader.fixed<std::uint32_t>() != CHECKPOINT_VERSION)
+  {
+    return false;
+  }
+
+  RevenuerManagerData header;
+
+  header.table_count = reader.fixed<std::uint32_t>();
+  header.begin_time = reader.fixed<std::int32_t>();
+  header.end_time = reader.fixed<std::int32_t>();
+  header.cost_per_hour = reader.fixed<std::uint32_t>();
+
+  auto input_offset = reader.fixed<std::uint64_t>();
+  auto input_digest = reader.fixed<std::uint64_t>();
+  auto output_offset = reader.fixed<std::uint64_t>();
+  auto last_time = reader.fixed<std::int32_t>();
+
+  // The same limits as the text header, and sizes are checked against the data
+  // left before anything is allocated.
+  if (!reader.good() || header.table_count == 0 || header.cost_per_hour == 0 ||
+      !validClock(header.begin_time) || !validClock(header.end_time) ||
+      (last_time != -1 && !validClock(last_time)) ||
+      header.table_count > reader.remaining() / TABLE_RECORD_SIZE)
+  {
+    return false;
+  }
+
+  setUp(header);
+
+  for (std::size_t table = 0; table < header.table_count; ++table) {
+    TableStatistic statistic;
+
+    statistic.revenue = reader.fixed<std::uint32_t>();
+    statistic.used_time = reader.fixed<std::uint32_t>();
+
+    auto since = reader.fixed<std::int32_t>();
+
+    table_client[table] = reader.fixed<ClientHandle>();
+
+    // Sessions start within the day and no later than the last event, which the
+    // settlement of all tables at once relies on.
+    if (since < TableStore::FREE || since >= MINUTES_PER_DAY || since > last_time) {
+      return false;
+    }
+    table_store.restore(table, statistic, since);
+  }
+
+  auto client_count = reader.varint();
+
+  if (client_count > reader.remaining()) {
+    return false;
+  }
+
+  client_table.resize(client_count, NOT_PRESENT);
+  client_wait_slot.resize(client_count, WaitQueue::NONE);
+  present_slot.resize(client_count);
+
+  for (ClientHandle client = 0; client < client_count; ++client) {
+    auto name = reader.string();
+    auto table = reader.fixed<std::int32_t>();
+
+    if (!reader.good() || clients.intern(name) != client || table < NOT_PRESENT ||
+        table >= static_cast<TableID>(header.table_count))
+    {
+      return false;
+    }
+
+    client_table[client] = table;
+
+    if (table != NOT_PRESENT) {
+      addPresent(client);
+    }
+  }
+
+  // Seated clients and busy tables have to point at each other.
+  for (std::size_t table = 0; table < header.table_count; ++table) {
+    auto client = table_client[table];
+
+    if (client == ClientInterner::NONE) {
+      if (table_store.busySince(table) != TableStore::FREE) {
+        return false;
+      }
+      continue;
+    }
+
+    if (client >= client_count || client_table[client] != static_cast<TableID>(table) ||
+        table_store.busySince(table) == TableStore::FREE)
+    {
+      return false;
+    }
+    free_tables.setBusy(table);
+  }
+
+  for (ClientHandle client = 0; client < client_count; ++client) {
+    auto table = client_table[client];
+
+    if (table >= 0 && table_client[table] != client) {
+      return false;
+    }
+  }
+
+  auto queue_length = reader.varint();
+
+  if (queue_length > header.table_count) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < queue_length; ++i) {
+    auto client = reader.varint();
+
+    if (client >= client_count || client_table[client] == NOT_PRESENT ||
+        client_wait_slot[client] != WaitQueue::NONE)
+    {
+      return false;
+    }
+    client_wait_slot[client] = client_queue.push(static_cast<ClientHandle>(client));
+  }
+
+  // A pending event could name a client who is gone or a table that is taken,
+  // none is left between input lines.
+  if (reader.varint() != 0) {
+    return false;
+  }
+
+  if (!reader.good() || reader.remaining() != 0 || !in.skip(input_offset) ||
+      in.digest() != input_digest)
+  {
+    return false;
+  }
+
+  last_time_event = last_time;
+  output_base = output_offset;
+  restored = true;
+
+  return true;
+}
+
+std::size_t RevenuerManager::outputOffset() const noexcept
+{
+  return output_base + out.writtenSize() + prepared.size();
+}
+
+std::size_t RevenuerManager::inputOffset() const noexcept
+{
+  return in.offset();
+}
+
+void RevenuerManager::writeCheckpointFile()
+{
+  checkpoint(checkpoint_data);
+
+  // Written aside and renamed, so a crash never leaves a torn checkpoint behind.
+  auto temporary_path = options.checkpoint_path + ".tmp";
+
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+
+    file.write(checkpoint_data.data(), checkpoint_data.size());
+
+    if (!file.flush()) {
+      LOG_WARNING(std::cerr) << "Cannot write checkpoint " << temporary_path;
+      return;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporary_path, options.checkpoint_path, error);
+
+  if (error) {
+    LOG_WARNING(std::cerr) << "Cannot write checkpoint " << options.checkpoint_path;
+  }
+}
+
+} // namespace task
@@ -0,0 +1,145 @@
+#include <RevenuerManager.hpp>
+
+#include <thread>
+
+namespace task {
+
+namespace {
+
+// Deep enough that neither thread waits on the other for a burst of errors or
+// clients leaving, small enough to stay in cache.
+constexpr std::size_t PIPELINE_RING_SIZE = 1024;
+
+} // namespace
+
+bool RevenuerManager::processEventsPipelined()
+{
+  SpscRing<ParsedLine> parsed_lines(PIPELINE_RING_SIZE);
+  SpscRing<TranscriptLine> transcript_lines(PIPELINE_RING_SIZE);
+
+  // Both threads are asked to stop and joined as they go out of scope, also when
+  // the simulation throws. The reader may be ahead of the simulation then.
+  std::jthread reader([this, &parsed_lines](std::stop_token stop) {
+    while (true) {
+      auto line = in.next();
+      ParsedLine parsed{.kind = ParsedLine::Kind::END, .line = line.value_or("")};
+
+      if (line.has_value()) {
+        auto event = line->empty() ? std::nullopt : InputEvent::tryGet(*line);
+
+        if (event.has_value()) {
+          parsed.kind = ParsedLine::Kind::EVENT;
+          parsed.event = *event;
+        } else {
+          parsed.kind =
+              line->empty() ? ParsedLine::Kind::EMPTY : ParsedLine::Kind::MALFORMED;
+        }
+      }
+
+      while (!parsed_lines.tryPush(parsed)) {
+        if (stop.stop_requested()) {
+          return;
+        }
+        std::this_thread::yield();
+      }
+
+      if (parsed.kind == ParsedLine::Kind::END ||
+          parsed.kind == ParsedLine::Kind::MALFORMED)
+      {
+        return;
+      }
+    }
+  });
+
+  // Only this thread touches the output until it is joined. It ends at the END line,
+  // or once it has written what is left if the simulation threw.
+  std::jthread formatter([this, &transcript_lines](std::stop_token stop) {
+    while (true) {
+      TranscriptLine line;
+
+      if (!transcript_lines.tryPop(line)) {
+        if (stop.stop_requested()) {
+          return;
+        }
+        std::this_thread::yield();
+        continue;
+      }
+
+      if (line.kind == TranscriptLine::Kind::END) {
+        return;
+      }
+      appendLine(prepared, line);
+      out.commit();
+    }
+  });
+
+  transcript = &transcript_lines;
+
+  bool accepted = false;
+
+  try {
+    accepted = simulate(parsed_lines);
+  } catch (...) {
+    transcript = nullptr;
+    throw;
+  }
+
+  transcript->push(TranscriptLine{.kind = TranscriptLine::Kind::END});
+  transcript = nullptr;
+
+  return accepted;
+}
+
+bool RevenuerManager::simulate(SpscRing<ParsedLine>& parsed_lines)
+{
+  bool input_ended = false;
+
+  // The other threads read, parse and format, so the read and output stages are
+  // the time this thread waits for a parsed line and for room in the transcript
+  // ring, and parsing is charged to reading.
+  while (true) {
+    stage_sampler.begin(run_stats);
+
+    if (!processPending()) {
+      return false;
+    }
+    stage_sampler.lap(run_stats, Stage::GENERATED_EVENT);
+
+    // Past the end of the input every line reads as empty, as in processEvents().
+    ParsedLine parsed{.kind = ParsedLine::Kind::END};
+
+    if (!input_ended) {
+      parsed = parsed_lines.pop();
+      input_ended = parsed.kind == ParsedLine::Kind::END;
+    }
+    stage_sampler.lap(run_stats, Stage::READ);
+
+    switch (parsed.kind) {
+    case ParsedLine::Kind::EMPTY:
+    case ParsedLine::Kind::END: {
+      if (!present_clients.empty()) {
+        kickOutLeftClients();
+        continue;
+      }
+      return true;
+    }
+    case ParsedLine::Kind::MALFORMED: {
+      error_line = parsed.line;
+      return false;
+    }
+    case ParsedLine::Kind::EVENT: {
+      if (processInputEvent(parsed.event) != Failure::NONE) {
+        error_line = parsed.line;
+        return false;
+      }
+      stage_sampler.lap(run_stats, Stage::INPUT_EVENT);
+
+      writeLine(TranscriptLine{.kind = TranscriptLine::Kind::INPUT, .text = parsed.line});
+      stage_sampler.lap(run_stats, Stage::OUTPUT);
+      break;
+    }
+    }
+  }
+}
+
+} // namespace task
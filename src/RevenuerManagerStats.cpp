@@ -0,0 +1,69 @@
+#include <RevenuerManager.hpp>
+
+namespace task {
+
+namespace {
+
+constexpr std::array<std::string_view, RunStats::STAGE_COUNT> STAGE_NAMES{
+    "read", "parse", "input_event", "generated_event", "output"};
+constexpr std::array<std::string_view, 4> INPUT_EVENT_NAMES{
+    "arrive", "take_table", "wait", "leave"};
+constexpr std::array<std::string_view, 3> GENERATED_EVENT_NAMES{
+    "leave", "take_table", "error"};
+
+// Keys contain no quotes or backslashes, so nothing has to be escaped.
+template<std::size_t Size>
+void writeCounters(
+    std::ostream& out, std::string_view key,
+    const std::array<std::string_view, Size>& names,
+    const std::array<std::uint64_t, Size>& values
+)
+{
+  out << "  \"" << key << "\": {";
+
+  for (std::size_t i = 0; i < Size; ++i) {
+    out << (i == 0 ? "" : ", ") << '"' << names[i] << "\": " << values[i];
+  }
+  out << "},\n";
+}
+
+} // namespace
+
+void RevenuerManager::writeRunStats(std::ostream& out) const
+{
+  // Each timed iteration stands for SAMPLE_INTERVAL of them.
+  std::array<std::uint64_t, RunStats::STAGE_COUNT> stage_ticks{};
+
+  if (run_stats.sampled_iterations > 0) {
+    for (std::size_t i = 0; i < stage_ticks.size(); ++i) {
+      stage_ticks[i] = static_cast<std::uint64_t>(
+          static_cast<double>(run_stats.stage_ticks[i]) * run_stats.iterations /
+          run_stats.sampled_iterations
+      );
+    }
+  }
+
+  out << "{\n";
+  out << "  \"enabled\": " << (STATS_ENABLED ? "true" : "false") << ",\n";
+  out << "  \"iterations\": " << run_stats.iterations << ",\n";
+  out << "  \"sampled_iterations\": " << run_stats.sampled_iterations << ",\n";
+  writeCounters(out, "stage_ticks", STAGE_NAMES, stage_ticks);
+  out << "  \"finalize_ticks\": " << run_stats.finalize_ticks << ",\n";
+  writeCounters(out, "input_events", INPUT_EVENT_NAMES, run_stats.input_events);
+  writeCounters(
+      out, "generated_events", GENERATED_EVENT_NAMES, run_stats.generated_events
+  );
+  writeCounters(out, "errors", GeneratedEvent::ERROR_MESSAGES, run_stats.errors);
+  out << "  \"peak_pending_events\": " << run_stats.peak_pending_events << ",\n";
+  out << "  \"peak_wait_queue\": " << run_stats.peak_wait_queue << ",\n";
+  out << "  \"peak_clients\": " << run_stats.peak_clients << ",\n";
+  out << "  \"distinct_clients\": " << clients.size() << "\n";
+  out << "}\n";
+}
+
+const RunStats& RevenuerManager::runStats() const noexcept
+{
+  return run_stats;
+}
+
+} // namespace task
@@ -0,0 +1,114 @@
+#include <Sections.hpp>
+#include <ThreadPool.hpp>
+#include <base_parser/Scanner.hpp>
+
+#include <algorithm>
+
+namespace task {
+
+namespace {
+
+// The run of a log from one of the places a section may start.
+struct SectionRun {
+  std::string transcript;
+  // Where the run stopped reading, the next section starts after it.
+  std::size_t end{0};
+  bool failed{false};
+};
+
+// Non-empty lines that follow an empty line or start the input.
+std::vector<std::size_t> sectionCandidates(std::string_view input)
+{
+  std::vector<std::size_t> candidates;
+  bool after_empty = true;
+
+  for (std::size_t pos = 0; pos < input.size();) {
+    auto line_end = base_parser::find(input, '\n', pos);
+
+    if (line_end != pos && after_empty) {
+      candidates.push_back(pos);
+    }
+    after_empty = line_end == pos;
+    pos = line_end + 1;
+  }
+
+  return candidates;
+}
+
+} // namespace
+
+std::size_t processSections(
+    std::string_view input, OutputTarget output, std::size_t jobs,
+    RevenuerManagerOptions options
+)
+{
+  // A section ends where a run of it stops reading: at an empty line with nobody in
+  // the club, or at its offending line. Which empty lines those are is only known
+  // by running, so a run starts at every line after an empty one on the threads,
+  // and the runs that start where the one before stopped are kept. The others
+  // begin mid-day and fail at their header.
+  auto candidates = sectionCandidates(input);
+  // The sections already keep the threads busy, and a pipelined run reads ahead of
+  // where it stops.
+  options.pipelined = false;
+  std::vector<SectionRun> runs(candidates.size());
+
+  if (jobs == 0) {
+    jobs = std::thread::hardware_concurrency();
+  }
+
+  ThreadPool pool(std::max<std::size_t>(1, std::min(jobs, candidates.size())));
+
+  pool.parallelFor(candidates.size(), [&](std::size_t i) {
+    auto& run = runs[i];
+    auto section = input.substr(candidates[i]);
+
+    try {
+      RevenuerManager manager(section, OutputTarget::appendTo(run.transcript), options);
+
+      run.failed = !manager.tryProcess();
+      run.end = candidates[i] + manager.inputOffset();
+
+      if (run.failed) {
+        run.transcript += manager.errorLine();
+        run.transcript += '\n';
+      }
+    } catch (const std::exception& e) {
+      run.transcript += e.what();
+      run.transcript += '\n';
+      run.failed = true;
+      run.end = candidates[i] + 1;
+    }
+  });
+
+  std::vector<std::string*> transcripts;
+  std::size_t failed_count = 0;
+  std::size_t next_begin = 0;
+
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    if (candidates[i] < next_begin) {
+      continue;
+    }
+    transcripts.push_back(&runs[i].transcript);
+    failed_count += runs[i].failed;
+    next_begin = runs[i].end;
+  }
+
+  OutputSink sink(output, OutputSink::FlushPolicy::THRESHOLD);
+
+  for (std::size_t i = 0; i < transcripts.size(); ++i) {
+    if (i > 0) {
+      sink.buffer() += '\n';
+    }
+    sink.buffer() += *transcripts[i];
+    sink.commit();
+
+    // Released as soon as it is written.
+    std::string().swap(*transcripts[i]);
+  }
+  sink.flush();
+
+  return failed_count;
+}
+
+} // namespace task
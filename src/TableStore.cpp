@@ -0,0 +1,277 @@
+#include <TableStore.hpp>
+#include <ThreadPool.hpp>
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace task {
+
+namespace {
+
+#if defined(__SSE2__) && !defined(__AVX2__)
+// 32-bit lane products, SSE2 only multiplies the even lanes into 64 bits.
+__m128i multiplyLanes(__m128i lhs, __m128i rhs) noexcept
+{
+  __m128i even = _mm_mul_epu32(lhs, rhs);
+  __m128i odd = _mm_mul_epu32(_mm_srli_epi64(lhs, 32), _mm_srli_epi64(rhs, 32));
+
+  return _mm_unpacklo_epi32(
+      _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+      _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0))
+  );
+}
+#endif
+
+} // namespace
+
+TableStore::TableStore(std::size_t table_count) :
+    table_count(table_count)
+{
+  auto padded = (table_count + LANES - 1) / LANES * LANES;
+
+  busy_since.resize(padded, FREE);
+  revenue.resize(padded, 0);
+  used_time.resize(padded, 0);
+}
+
+std::size_t TableStore::size() const noexcept
+{
+  return table_count;
+}
+
+TableStatistic
+TableStore::accrued(std::size_t table, int time, uint cost_per_hour) const noexcept
+{
+  auto result = statistic(table);
+
+  if (busy_since[table] != FREE) {
+    uint passed_time = time - busy_since[table];
+
+    result.revenue += billedHours(passed_time) * cost_per_hour;
+    result.used_time += passed_time;
+  }
+  return result;
+}
+
+void TableStore::release(std::size_t table, int time, uint cost_per_hour) noexcept
+{
+  auto settled = accrued(table, time, cost_per_hour);
+
+  revenue[table] = settled.revenue;
+  used_time[table] = settled.used_time;
+  busy_since[table] = FREE;
+}
+
+void TableStore::restore(std::size_t table, TableStatistic statistic, int since) noexcept
+{
+  revenue[table] = statistic.revenue;
+  used_time[table] = statistic.used_time;
+  busy_since[table] = since;
+}
+
+// Per lane: the session length, the hours billed for it by the same multiply and
+// shift as billedHours(), both masked to the busy lanes, and FREE for every lane.
+// Session lengths fit 16 bits, so the multiplication is a 16-bit high product
+// followed by one more shift.
+void TableStore::releaseAll(int time, uint cost_per_hour) noexcept
+{
+  std::size_t table = 0;
+
+#if defined(__AVX2__)
+  const __m256i now = _mm256_set1_epi32(time);
+  const __m256i cost = _mm256_set1_epi32(static_cast<int>(cost_per_hour));
+  const __m256i unoccupied = _mm256_set1_epi32(FREE);
+  const __m256i round_up = _mm256_set1_epi32(59);
+  const __m256i reciprocal = _mm256_set1_epi32(2185);
+
+  for (; table < busy_since.size(); table += 8) {
+    auto* since_lanes = reinterpret_cast<__m256i*>(busy_since.data() + table);
+    auto* revenue_lanes = reinterpret_cast<__m256i*>(revenue.data() + table);
+    auto* used_lanes = reinterpret_cast<__m256i*>(used_time.data() + table);
+
+    __m256i since = _mm256_load_si256(since_lanes);
+    __m256i busy = _mm256_cmpgt_epi32(since, unoccupied);
+    __m256i passed = _mm256_sub_epi32(now, since);
+    __m256i hours = _mm256_srli_epi32(
+        _mm256_mulhi_epu16(_mm256_add_epi32(passed, round_up), reciprocal), 1
+    );
+    __m256i charge = _mm256_mullo_epi32(hours, cost);
+
+    _mm256_store_si256(
+        revenue_lanes,
+        _mm256_add_epi32(_mm256_load_si256(revenue_lanes), _mm256_and_si256(busy, charge))
+    );
+    _mm256_store_si256(
+        used_lanes,
+        _mm256_add_epi32(_mm256_load_si256(used_lanes), _mm256_and_si256(busy, passed))
+    );
+    _mm256_store_si256(since_lanes, unoccupied);
+  }
+#elif defined(__SSE2__)
+  const __m128i now = _mm_set1_epi32(time);
+  const __m128i cost = _mm_set1_epi32(static_cast<int>(cost_per_hour));
+  const __m128i unoccupied = _mm_set1_epi32(FREE);
+  const __m128i round_up = _mm_set1_epi32(59);
+  const __m128i reciprocal = _mm_set1_epi32(2185);
+
+  for (; table < busy_since.size(); table += 4) {
+    auto* since_lanes = reinterpret_cast<__m128i*>(busy_since.data() + table);
+    auto* revenue_lanes = reinterpret_cast<__m128i*>(revenue.data() + table);
+    auto* used_lanes = reinterpret_cast<__m128i*>(used_time.data() + table);
+
+    __m128i since = _mm_load_si128(since_lanes);
+    __m128i busy = _mm_cmpgt_epi32(since, unoccupied);
+    __m128i passed = _mm_sub_epi32(now, since);
+    __m128i hours = _mm_srli_epi32(
+        _mm_mulhi_epu16(_mm_add_epi32(passed, round_up), reciprocal), 1
+    );
+    __m128i charge = multiplyLanes(hours, cost);
+
+    _mm_store_si128(
+        revenue_lanes,
+        _mm_add_epi32(_mm_load_si128(revenue_lanes), _mm_and_si128(busy, charge))
+    );
+    _mm_store_si128(
+        used_lanes,
+        _mm_add_epi32(_mm_load_si128(used_lanes), _mm_and_si128(busy, passed))
+    );
+    _mm_store_si128(since_lanes, unoccupied);
+  }
+#endif
+
+  for (; table < busy_since.size(); ++table) {
+    if (busy_since[table] != FREE) {
+      release(table, time, cost_per_hour);
+    }
+  }
+}
+
+TableSummary TableStore::summary() const noexcept
+{
+  TableSummary result;
+  std::size_t table = 0;
+
+#if defined(__AVX2__)
+  __m256i revenue_sum = _mm256_setzero_si256();
+  __m256i used_sum = _mm256_setzero_si256();
+  __m256i busy_count = _mm256_setzero_si256();
+  const __m256i unoccupied = _mm256_set1_epi32(FREE);
+
+  for (; table < busy_since.size(); table += 8) {
+    auto revenue_lanes =
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(revenue.data() + table));
+    auto used_lanes =
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(used_time.data() + table));
+    auto since =
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(busy_since.data() + table));
+
+    // Widened to 64 bits, the revenues of many tables do not fit 32.
+    revenue_sum = _mm256_add_epi64(
+        revenue_sum, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(revenue_lanes))
+    );
+    revenue_sum = _mm256_add_epi64(
+        revenue_sum, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(revenue_lanes, 1))
+    );
+    used_sum = _mm256_add_epi64(
+        used_sum, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(used_lanes))
+    );
+    used_sum = _mm256_add_epi64(
+        used_sum, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(used_lanes, 1))
+    );
+    // Busy lanes compare to all ones, that is minus one.
+    busy_count = _mm256_sub_epi32(busy_count, _mm256_cmpgt_epi32(since, unoccupied));
+  }
+
+  alignas(32) std::uint64_t revenue_parts[4];
+  alignas(32) std::uint64_t used_parts[4];
+  alignas(32) std::uint32_t busy_parts[8];
+
+  _mm256_store_si256(reinterpret_cast<__m256i*>(revenue_parts), revenue_sum);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(used_parts), used_sum);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(busy_parts), busy_count);
+
+  for (std::size_t i = 0; i < 4; ++i) {
+    result.revenue += revenue_parts[i];
+    result.used_time += used_parts[i];
+  }
+  for (std::size_t i = 0; i < 8; ++i) {
+    result.busy_tables += busy_parts[i];
+  }
+#elif defined(__SSE2__)
+  __m128i revenue_sum = _mm_setzero_si128();
+  __m128i used_sum = _mm_setzero_si128();
+  __m128i busy_count = _mm_setzero_si128();
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i unoccupied = _mm_set1_epi32(FREE);
+
+  for (; table < busy_since.size(); table += 4) {
+    auto revenue_lanes =
+        _mm_load_si128(reinterpret_cast<const __m128i*>(revenue.data() + table));
+    auto used_lanes =
+        _mm_load_si128(reinterpret_cast<const __m128i*>(used_time.data() + table));
+    auto since =
+        _mm_load_si128(reinterpret_cast<const __m128i*>(busy_since.data() + table));
+
+    // Widened to 64 bits, the revenues of many tables do not fit 32.
+    revenue_sum = _mm_add_epi64(revenue_sum, _mm_unpacklo_epi32(revenue_lanes, zero));
+    revenue_sum = _mm_add_epi64(revenue_sum, _mm_unpackhi_epi32(revenue_lanes, zero));
+    used_sum = _mm_add_epi64(used_sum, _mm_unpacklo_epi32(used_lanes, zero));
+    used_sum = _mm_add_epi64(used_sum, _mm_unpackhi_epi32(used_lanes, zero));
+    // Busy lanes compare to all ones, that is minus one.
+    busy_count = _mm_sub_epi32(busy_count, _mm_cmpgt_epi32(since, unoccupied));
+  }
+
+  alignas(16) std::uint64_t revenue_parts[2];
+  alignas(16) std::uint64_t used_parts[2];
+  alignas(16) std::uint32_t busy_parts[4];
+
+  _mm_store_si128(reinterpret_cast<__m128i*>(revenue_parts), revenue_sum);
+  _mm_store_si128(reinterpret_cast<__m128i*>(used_parts), used_sum);
+  _mm_store_si128(reinterpret_cast<__m128i*>(busy_parts), busy_count);
+
+  result.revenue = revenue_parts[0] + revenue_parts[1];
+  result.used_time = used_parts[0] + used_parts[1];
+  for (std::size_t i = 0; i < 4; ++i) {
+    result.busy_tables += busy_parts[i];
+  }
+#endif
+
+  for (; table < busy_since.size(); ++table) {
+    result.revenue += revenue[table];
+    result.used_time += used_time[table];
+    result.busy_tables += busy_since[table] != FREE;
+  }
+
+  return result;
+}
+
+TableSummary
+summarizeClubs(const std::vector<const TableStore*>& stores, std::size_t jobs)
+{
+  // One summary per club, added up in order once the threads are done.
+  std::vector<TableSummary> summaries(stores.size());
+
+  if (jobs == 0) {
+    jobs = std::thread::hardware_concurrency();
+  }
+
+  ThreadPool pool(std::max<std::size_t>(1, std::min(jobs, stores.size())));
+
+  pool.parallelFor(stores.size(), [&](std::size_t i) {
+    summaries[i] = stores[i]->summary();
+  });
+
+  TableSummary total;
+
+  for (auto& summary : summaries) {
+    total += summary;
+  }
+  return total;
+}
+
+} // namespace task
@@ -0,0 +1,195 @@
+#include <ThreadPool.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace task {
+
+namespace {
+
+constexpr std::uint64_t pack(std::uint64_t begin, std::uint64_t end) noexcept
+{
+  return (begin << 32) | end;
+}
+
+constexpr std::uint64_t rangeBegin(std::uint64_t bounds) noexcept
+{
+  return bounds >> 32;
+}
+
+constexpr std::uint64_t rangeEnd(std::uint64_t bounds) noexcept
+{
+  return bounds & std::numeric_limits<std::uint32_t>::max();
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t thread_count)
+{
+  if (thread_count == 0) {
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  ranges = std::make_unique<Range[]>(thread_count);
+
+  // The calling thread takes part in every loop.
+  workers.reserve(thread_count - 1);
+
+  for (std::size_t i = 1; i < thread_count; ++i) {
+    workers.emplace_back(&ThreadPool::work, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  job_ready.notify_all();
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+std::size_t ThreadPool::size() const noexcept
+{
+  return workers.size() + 1;
+}
+
+void ThreadPool::parallelFor(std::size_t count, const Task& task)
+{
+  if (count == 0) {
+    return;
+  }
+
+  {
+    std::lock_guard lock(mutex);
+
+    auto participants = size();
+
+    for (std::size_t i = 0; i < participants; ++i) {
+      ranges[i].bounds.store(
+          pack(count * i / participants, count * (i + 1) / participants),
+          std::memory_order_relaxed
+      );
+    }
+
+    job = &task;
+    remaining.store(count, std::memory_order_relaxed);
+    ++generation;
+  }
+  job_ready.notify_all();
+
+  runTasks(0, task);
+
+  std::unique_lock lock(mutex);
+  job_done.wait(lock, [this] {
+    return remaining.load(std::memory_order_acquire) == 0 && active_workers == 0;
+  });
+  job = nullptr;
+}
+
+void ThreadPool::work(std::size_t participant)
+{
+  std::size_t seen_generation = 0;
+
+  while (true) {
+    const Task* task = nullptr;
+
+    {
+      std::unique_lock lock(mutex);
+      job_ready.wait(lock, [&] {
+        return stopping || generation != seen_generation;
+      });
+
+      if (stopping) {
+        return;
+      }
+      seen_generation = generation;
+
+      if (job == nullptr) {
+        continue;
+      }
+      task = job;
+      ++active_workers;
+    }
+
+    runTasks(participant, *task);
+
+    {
+      std::lock_guard lock(mutex);
+      --active_workers;
+    }
+    job_done.notify_all();
+  }
+}
+
+void ThreadPool::runTasks(std::size_t participant, const Task& task)
+{
+  while (true) {
+    auto index = takeOwn(participant);
+
+    if (!index.has_value()) {
+      index = steal(participant);
+    }
+    if (!index.has_value()) {
+      return;
+    }
+
+    task(*index);
+
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      // Taking the lock orders the notification after the waiter's check.
+      {
+        std::lock_guard lock(mutex);
+      }
+      job_done.notify_all();
+    }
+  }
+}
+
+std::optional<std::size_t> ThreadPool::takeOwn(std::size_t participant) noexcept
+{
+  auto& bounds = ranges[participant].bounds;
+  auto current = bounds.load(std::memory_order_acquire);
+
+  while (rangeBegin(current) < rangeEnd(current)) {
+    auto next = pack(rangeBegin(current) + 1, rangeEnd(current));
+
+    if (bounds.compare_exchange_weak(current, next, std::memory_order_acq_rel)) {
+      return rangeBegin(current);
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::size_t> ThreadPool::steal(std::size_t participant) noexcept
+{
+  auto participants = size();
+
+  for (std::size_t offset = 1; offset < participants; ++offset) {
+    auto& bounds = ranges[(participant + offset) % participants].bounds;
+    auto current = bounds.load(std::memory_order_acquire);
+
+    while (rangeBegin(current) < rangeEnd(current)) {
+      auto begin = rangeBegin(current);
+      auto end = rangeEnd(current);
+      auto middle = begin + (end - begin) / 2;
+
+      // The victim keeps the front half, the thief runs `middle` and keeps the
+      // rest of the back half as its own range.
+      if (bounds.compare_exchange_weak(
+              current, pack(begin, middle), std::memory_order_acq_rel
+          ))
+      {
+        ranges[participant].bounds.store(pack(middle + 1, end), std::memory_order_release);
+        return middle;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace task
@@ -0,0 +1,174 @@
+#include <LineReader.hpp>
+#include <RevenuerManager.hpp>
+#include <ThreadPool.hpp>
+#include <Validation.hpp>
+#include <base_parser/Scanner.hpp>
+#include <types/InputEvent.hpp>
+#include <types/RevenuerManagerData.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace task {
+
+namespace {
+
+// Smaller chunks would cost more to schedule than to check.
+constexpr std::size_t MIN_CHUNK_SIZE = 1 << 16;
+// More chunks than threads, so a thread that is done early steals from the others.
+constexpr std::size_t CHUNKS_PER_THREAD = 4;
+
+// What a chunk holds up to its first offending line. Whether its events follow
+// those of the chunks before it is only known once they are all checked.
+struct ChunkResult {
+  std::string_view first_line;
+  // Times of the first and the last valid event, -1 if there is none.
+  int first_time{-1};
+  int last_time{-1};
+  std::string_view error_line;
+  bool failed{false};
+  // Before the offending line, if any.
+  bool has_empty_line{false};
+};
+
+ChunkResult checkChunk(std::string_view chunk, unsigned int table_count)
+{
+  ChunkResult result;
+  std::size_t pos = 0;
+
+  while (pos < chunk.size()) {
+    auto line_end = base_parser::find(chunk, '\n', pos);
+    auto line = chunk.substr(pos, line_end - pos);
+
+    if (pos == 0) {
+      result.first_line = line;
+    }
+    pos = line_end + 1;
+
+    if (line.empty()) {
+      result.has_empty_line = true;
+      continue;
+    }
+
+    auto event = InputEvent::tryGet(line);
+
+    if (!event.has_value() || event->time < result.last_time ||
+        (event->type == InputEvent::Type::CLIENT_TAKE_TABLE &&
+         event->table_id >= table_count))
+    {
+      result.error_line = line;
+      result.failed = true;
+      break;
+    }
+
+    if (result.first_time == -1) {
+      result.first_time = event->time;
+    }
+    result.last_time = event->time;
+  }
+
+  return result;
+}
+
+// Splits the events into chunks of about the same size that end on a newline.
+std::vector<std::string_view> splitChunks(std::string_view events, std::size_t count)
+{
+  std::vector<std::string_view> chunks;
+  std::size_t begin = 0;
+
+  for (std::size_t i = 1; i <= count && begin < events.size(); ++i) {
+    auto end = events.size() * i / count;
+
+    if (i < count) {
+      auto line_end = base_parser::find(events, '\n', std::max(begin, end));
+
+      end = std::min(line_end + 1, events.size());
+    }
+    chunks.push_back(events.substr(begin, end - begin));
+    begin = end;
+  }
+
+  return chunks;
+}
+
+} // namespace
+
+bool validateLog(std::string_view input, std::size_t jobs, std::string& error_line)
+{
+  LineReader reader(input);
+  std::string header;
+
+  for (int i = 0; i < 3; ++i) {
+    auto line = reader.next();
+
+    if (!line.has_value()) {
+      break;
+    }
+    header += *line;
+    header += '\n';
+  }
+
+  std::string_view header_error_line;
+  auto data = RevenuerManagerData::tryGet(header, &header_error_line);
+
+  if (!data.has_value()) {
+    error_line = header_error_line;
+    return false;
+  }
+
+  if (jobs == 0) {
+    jobs = std::thread::hardware_concurrency();
+  }
+
+  auto events = input.substr(reader.offset());
+  auto max_chunk_count = std::max<std::size_t>(1, jobs) * CHUNKS_PER_THREAD;
+  auto chunk_count =
+      std::clamp<std::size_t>(events.size() / MIN_CHUNK_SIZE, 1, max_chunk_count);
+  auto chunks = splitChunks(events, chunk_count);
+  std::vector<ChunkResult> results(chunks.size());
+
+  ThreadPool pool(std::max<std::size_t>(1, std::min(jobs, chunks.size())));
+
+  pool.parallelFor(chunks.size(), [&](std::size_t i) {
+    results[i] = checkChunk(chunks[i], data->table_count);
+  });
+
+  // Times have to keep growing across chunks as well.
+  int last_time = -1;
+
+  for (const auto& result : results) {
+    if (!result.first_line.empty() && result.first_time != -1 &&
+        result.first_time < last_time)
+    {
+      error_line = result.first_line;
+      return false;
+    }
+
+    // The day only ends at an empty line if nobody is in the club, otherwise they
+    // are sent away and the log goes on. Who is there is only known by running the
+    // events, so the log is run to find where it stops.
+    if (result.has_empty_line) {
+      std::ostream discarded(nullptr);
+      RevenuerManager manager(input, discarded, {.streaming = true});
+
+      if (!manager.tryProcess()) {
+        error_line = manager.errorLine();
+        return false;
+      }
+      return true;
+    }
+
+    if (result.failed) {
+      error_line = result.error_line;
+      return false;
+    }
+
+    if (result.last_time != -1) {
+      last_time = result.last_time;
+    }
+  }
+
+  return true;
+}
+
+} // namespace task
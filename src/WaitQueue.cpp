@@ -0,0 +1,93 @@
+#include <WaitQueue.hpp>
+
+namespace task {
+
+WaitQueue::WaitQueue(std::size_t capacity) :
+    clients(capacity + 1, ClientInterner::NONE),
+    next(capacity + 1),
+    prev(capacity + 1),
+    sentinel(static_cast<Slot>(capacity)),
+    free_head(capacity == 0 ? NONE : 0)
+{
+  for (Slot slot = 0; slot < sentinel; ++slot) {
+    next[slot] = slot + 1 < sentinel ? slot + 1 : NONE;
+  }
+
+  next[sentinel] = sentinel;
+  prev[sentinel] = sentinel;
+}
+
+bool WaitQueue::empty() const noexcept
+{
+  return count == 0;
+}
+
+bool WaitQueue::full() const noexcept
+{
+  return free_head == NONE;
+}
+
+std::size_t WaitQueue::size() const noexcept
+{
+  return count;
+}
+
+WaitQueue::Slot WaitQueue::push(ClientHandle client) noexcept
+{
+  auto slot = free_head;
+  free_head = next[slot];
+
+  clients[slot] = client;
+  next[slot] = sentinel;
+  prev[slot] = prev[sentinel];
+  next[prev[sentinel]] = slot;
+  prev[sentinel] = slot;
+
+  ++count;
+
+  return slot;
+}
+
+ClientHandle WaitQueue::front() const noexcept
+{
+  return clients[next[sentinel]];
+}
+
+void WaitQueue::pop() noexcept
+{
+  unlink(next[sentinel]);
+}
+
+void WaitQueue::remove(Slot slot) noexcept
+{
+  unlink(slot);
+}
+
+void WaitQueue::clear() noexcept
+{
+  if (count == 0) {
+    return;
+  }
+
+  // The ring of waiting clients is spliced onto the free chain as a whole.
+  next[prev[sentinel]] = free_head;
+  free_head = next[sentinel];
+
+  next[sentinel] = sentinel;
+  prev[sentinel] = sentinel;
+  count = 0;
+}
+
+void WaitQueue::unlink(Slot slot) noexcept
+{
+  next[prev[slot]] = next[slot];
+  prev[next[slot]] = prev[slot];
+
+  clients[slot] = ClientInterner::NONE;
+  next[slot] = free_head;
+  free_head = slot;
+
+  --count;
+}
+
+} // namespace task
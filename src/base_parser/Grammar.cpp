@@ -0,0 +1,27 @@
+#include <base_parser/Grammar.hpp>
+
+#include <algorithm>
+
+namespace base_parser {
+
+std::string_view lineAt(std::string_view data, std::size_t index) noexcept
+{
+  std::size_t line_begin{0};
+  std::size_t line_end{std::min(index, data.empty() ? 0 : data.size() - 1)};
+
+  // The line is only looked up on failure.
+  for (auto i = line_end; i > 0; --i) {
+    if (data[i - 1] == '\n') {
+      line_begin = i;
+      break;
+    }
+  }
+
+  while (line_end < data.size() && data[line_end] && data[line_end] != '\n') {
+    ++line_end;
+  }
+
+  return data.substr(line_begin, line_end - line_begin);
+}
+
+} // namespace base_parser
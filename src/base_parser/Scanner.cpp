@@ -0,0 +1,61 @@
+#include <base_parser/Scanner.hpp>
+
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace base_parser {
+
+std::size_t find(std::string_view data, char value, std::size_t from) noexcept
+{
+  const char* bytes = data.data();
+  std::size_t pos = from;
+  std::size_t size = data.size();
+
+  if (from >= size) {
+    return size;
+  }
+
+#if defined(__AVX2__)
+  const __m256i needle32 = _mm256_set1_epi8(value);
+
+  for (; pos + 32 <= size; pos += 32) {
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + pos));
+    auto mask = static_cast<unsigned int>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle32))
+    );
+
+    if (mask != 0) {
+      return pos + std::countr_zero(mask);
+    }
+  }
+#endif
+
+#if defined(__SSE2__)
+  const __m128i needle16 = _mm_set1_epi8(value);
+
+  for (; pos + 16 <= size; pos += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + pos));
+    auto mask =
+        static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle16)));
+
+    if (mask != 0) {
+      return pos + std::countr_zero(mask);
+    }
+  }
+#endif
+
+  for (; pos < size; ++pos) {
+    if (bytes[pos] == value) {
+      return pos;
+    }
+  }
+
+  return size;
+}
+
+} // namespace base_parser
@@ -1,51 +1,308 @@
 #include <log.hpp>
 
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace {
+
+// Bounded multi-producer queue of records drained by one log thread. Every slot
+// carries a sequence number telling whose turn it is: a producer claims the next
+// position with a compare-and-swap and publishes the slot by advancing its sequence,
+// the log thread hands it back by advancing it by the capacity. Record texts are
+// swapped rather than copied, so a thread's buffer and the slots keep their
+// capacity and logging stops allocating once they have grown.
+class AsyncLog {
+  static constexpr std::size_t CAPACITY = 1024;
+
+  struct Slot {
+    std::atomic<std::uint64_t> sequence;
+    std::ostream* out;
+    std::string text;
+  };
+
+public:
+  AsyncLog() :
+      slots(std::make_unique<Slot[]>(CAPACITY))
+  {
+    for (std::size_t i = 0; i < CAPACITY; ++i) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    worker = std::thread([this] { drain(); });
+  }
+
+  // Writes what is left before the program ends.
+  ~AsyncLog()
+  {
+    stopping.store(true);
+    wake_count.fetch_add(1);
+    wake_count.notify_one();
+    worker.join();
+  }
+
+  // Takes the record out of `text` and leaves a cleared buffer in its place.
+  void push(std::ostream& out, std::string& text)
+  {
+    auto pos = enqueue_pos.load(std::memory_order_relaxed);
+    Slot* slot;
+
+    while (true) {
+      slot = &slots[pos % CAPACITY];
+
+      auto sequence = slot->sequence.load(std::memory_order_acquire);
+      auto lag = static_cast<std::int64_t>(sequence - pos);
+
+      if (lag == 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (lag < 0) {
+        // Full, the slot still holds the record from a lap ago.
+        if (overflow.load(std::memory_order_relaxed) == task::LogOverflow::DROP) {
+          dropped.fetch_add(1, std::memory_order_relaxed);
+          text.clear();
+          return;
+        }
+        std::this_thread::yield();
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      } else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->out = &out;
+    slot->text.swap(text);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    published.fetch_add(1, std::memory_order_release);
+    wake();
+  }
+
+  void flush()
+  {
+    auto target = published.load(std::memory_order_acquire);
+
+    for (auto done = written.load(std::memory_order_acquire); done < target;
+         done = written.load(std::memory_order_acquire))
+    {
+      written.wait(done);
+    }
+  }
+
+  std::atomic<task::LogLevel> level{task::LogLevel::DEBUG};
+  std::atomic<task::LogOverflow> overflow{task::LogOverflow::BLOCK};
+  std::atomic<std::uint64_t> dropped{0};
+
+private:
+  // Wakes the log thread if it is asleep. Paired with the fence in drain(): either
+  // the log thread sees the new record or this sees it asleep.
+  void wake()
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (sleeping.load(std::memory_order_relaxed)) {
+      wake_count.fetch_add(1, std::memory_order_relaxed);
+      wake_count.notify_one();
+    }
+  }
+
+  bool ready() const noexcept
+  {
+    return slots[dequeue_pos % CAPACITY].sequence.load(std::memory_order_acquire) ==
+           dequeue_pos + 1;
+  }
+
+  void drain()
+  {
+    std::string batch;
+    std::ostream* batch_out = nullptr;
+
+    auto write = [&batch, &batch_out] {
+      if (!batch.empty()) {
+        batch_out->write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        batch_out->flush();
+        batch.clear();
+      }
+    };
+
+    while (true) {
+      std::uint64_t taken = 0;
+
+      // Everything published so far goes out in one write per run of records to the
+      // same stream.
+      while (ready()) {
+        auto& slot = slots[dequeue_pos % CAPACITY];
+
+        if (slot.out != batch_out) {
+          write();
+          batch_out = slot.out;
+        }
+        batch += slot.text;
+        slot.text.clear();
+        slot.sequence.store(dequeue_pos + CAPACITY, std::memory_order_release);
+
+        ++dequeue_pos;
+        ++taken;
+      }
+
+      if (taken > 0) {
+        write();
+        written.fetch_add(taken, std::memory_order_release);
+        written.notify_all();
+        continue;
+      }
+
+      if (stopping.load()) {
+        return;
+      }
+
+      auto seen = wake_count.load(std::memory_order_relaxed);
+
+      sleeping.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if (!ready() && !stopping.load()) {
+        wake_count.wait(seen, std::memory_order_relaxed);
+      }
+      sleeping.store(false, std::memory_order_relaxed);
+    }
+  }
+
+  std::unique_ptr<Slot[]> slots;
+
+  alignas(64) std::atomic<std::uint64_t> enqueue_pos{0};
+  // Only touched by the log thread.
+  alignas(64) std::uint64_t dequeue_pos{0};
+
+  // Records published and written so far, for flush().
+  std::atomic<std::uint64_t> published{0};
+  std::atomic<std::uint64_t> written{0};
+
+  // Bumped to wake the log thread, which waits on it while there is nothing to write.
+  std::atomic<std::uint32_t> wake_count{0};
+  std::atomic<bool> sleeping{false};
+  std::atomic<bool> stopping{false};
+
+  std::thread worker;
+};
+
+AsyncLog& asyncLog()
+{
+  static AsyncLog log;
+  return log;
+}
+
+// Reused by every record of the thread, unless one is formatted while another one
+// is, e.g. by a function called in the middle of a record.
+thread_local std::string thread_buffer;
+thread_local bool thread_buffer_used{false};
+
+} // namespace
+
+namespace task {
+
+void setLogLevel(LogLevel level) noexcept
+{
+  asyncLog().level.store(level, std::memory_order_relaxed);
+}
+
+void setLogOverflow(LogOverflow policy) noexcept
+{
+  asyncLog().overflow.store(policy, std::memory_order_relaxed);
+}
+
+void flushLog()
+{
+  asyncLog().flush();
+}
+
+std::uint64_t droppedLogRecords() noexcept
+{
+  return asyncLog().dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace task
+
 namespace defines_details {
 
-LogStreamer::LogStreamer(std::ostream& out_) noexcept :
-    out(out_)
-{}
+LogStreamer::LogStreamer(std::ostream& out_, task::LogLevel level) noexcept :
+    out(&out_)
+{
+  if (level < asyncLog().level.load(std::memory_order_relaxed)) {
+    holded = false;
+    return;
+  }
+
+  if (thread_buffer_used) {
+    text = &own;
+  } else {
+    thread_buffer_used = true;
+    text = &thread_buffer;
+  }
+}
 
 LogStreamer::~LogStreamer()
 {
-  if (holded) {
-    out << std::endl;
+  if (!holded) {
+    return;
+  }
+
+  *text += '\n';
+  asyncLog().push(*out, *text);
+
+  if (text == &thread_buffer) {
+    thread_buffer_used = false;
+  }
+
+  // The log thread holds on to the stream until the record is written, only the
+  // standard streams are sure to outlive it.
+  if (out != &std::cout && out != &std::cerr && out != &std::clog) {
+    asyncLog().flush();
   }
 }
 
-LogStreamer::LogStreamer(LogStreamer& other) noexcept :
-    out(other.out)
+LogStreamer::LogStreamer(LogStreamer& other) noexcept
 {
-  other.holded = false;
+  takeFrom(other);
 }
 
-LogStreamer::LogStreamer(LogStreamer&& other) noexcept :
-    out(other.out)
+LogStreamer::LogStreamer(LogStreamer&& other) noexcept
 {
+  takeFrom(other);
+}
+
+void LogStreamer::takeFrom(LogStreamer& other) noexcept
+{
+  out = other.out;
+  holded = other.holded;
+  own = std::move(other.own);
+  text = other.text == &other.own ? &own : other.text;
+
   other.holded = false;
+  other.text = nullptr;
 }
 
 LogStreamer log_info_impl(std::ostream& out)
 {
-  LogStreamer streamer(out);
+  LogStreamer streamer(out, task::LogLevel::INFO);
   return streamer << "   [INFO] ";
 }
 
 LogStreamer log_debug_impl(std::ostream& out)
 {
-  LogStreamer streamer(out);
+  LogStreamer streamer(out, task::LogLevel::DEBUG);
   return streamer << "  [DEBUG] ";
 }
 
 LogStreamer log_warning_impl(std::ostream& out)
 {
-  LogStreamer streamer(out);
+  LogStreamer streamer(out, task::LogLevel::WARNING);
   return streamer << "[WARNING] ";
 }
 
 LogStreamer log_error_impl(std::ostream& out)
 {
-  LogStreamer streamer(out);
+  LogStreamer streamer(out, task::LogLevel::ERROR);
   return streamer << "  [ERROR] ";
 }
 
@@ -1,31 +1,348 @@
+#include <charconv>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <string_view>
 
+#include <Batch.hpp>
+#include <BinaryLog.hpp>
+#include <MappedFile.hpp>
 #include <RevenuerManager.hpp>
+#include <Sections.hpp>
+#include <Validation.hpp>
 #include <log.hpp>
 #include <return_codes.h>
 
-int main(int argc, char** argv)
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t DEFAULT_CHECKPOINT_INTERVAL = 100'000;
+
+int usage()
 {
-  if (argc != 2) {
-    LOG_ERROR() << "Invalid parameter.";
-    LOG_ERROR() << "Usage: <program> <input-file>";
+  LOG_ERROR() << "Invalid parameter.";
+  LOG_ERROR() << "Usage: <program> [options] <input-file>";
+  LOG_ERROR() << "       <program> [options] --batch <directory|glob> [--jobs N]";
+  LOG_ERROR() << "       <program> [options] --sections <input-file> [--jobs N]";
+  LOG_ERROR() << "       <program> --validate <input-file> [--jobs N]";
+  LOG_ERROR() << "       <program> convert <input-file> <output-file>";
+  LOG_ERROR() << "Options: --stream --line-buffered --auto-assign --pipelined";
+  LOG_ERROR() << "         --checkpoint <file> [--checkpoint-every N] --resume <file>";
+  LOG_ERROR() << "         --stats";
 
-    return ERROR_INVALID_PARAMETER;
+  return ERROR_INVALID_PARAMETER;
+}
+
+// Reads a whole file, mapped when possible.
+bool readFile(const char* path, task::MappedFile& mapped, std::string& copy)
+{
+  if (mapped) {
+    return true;
   }
 
-  std::ifstream in(argv[1]);
+  std::ifstream in(path, std::ios::binary);
 
   if (!in) {
+    return false;
+  }
+  copy.assign(std::istreambuf_iterator<char>(in), {});
+
+  return true;
+}
+
+// Text logs become binary and binary logs become text.
+int runConvert(const char* input_path, const char* output_path)
+{
+  task::MappedFile mapped(input_path);
+  std::string copy;
+
+  if (!readFile(input_path, mapped, copy)) {
     LOG_ERROR() << "Input file not found.";
     return ERROR_FILE_NOT_FOUND;
   }
 
-  task::RevenuerManager manager(in, std::cout);
+  auto input = mapped ? mapped.view() : std::string_view(copy);
+  std::string converted;
+
+  if (task::isBinaryLog(input)) {
+    if (!task::binaryLogToText(input, converted)) {
+      LOG_ERROR() << "Malformed binary log.";
+      return ERROR_INVALID_DATA;
+    }
+  } else {
+    std::string error_line;
 
-  try {
-    manager.process();
-  } catch (const std::runtime_error& e) {
-    std::cout << e.what() << '\n';
+    if (!task::textToBinaryLog(input, converted, error_line)) {
+      LOG_ERROR() << "Malformed line: " << error_line;
+      return ERROR_INVALID_DATA;
+    }
   }
+
+  std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+
+  if (!out.write(converted.data(), converted.size())) {
+    LOG_ERROR() << "Cannot write the output file.";
+    return ERROR_PATH_NOT_FOUND;
+  }
+
+  return ERROR_SUCCESS;
+}
+
+int runBinary(
+    std::string_view input, task::OutputTarget output, task::RevenuerManagerOptions options
+)
+{
+  std::string error_line;
+
+  if (task::processBinaryLog(input, output, options, error_line)) {
+    return ERROR_SUCCESS;
+  }
+
+  if (error_line.empty()) {
+    LOG_ERROR() << "Malformed binary log.";
+    return ERROR_INVALID_DATA;
+  }
+
+  std::cout << error_line << '\n';
+
+  return ERROR_SUCCESS;
+}
+
+// With `stats`, the counters of the run are written to stderr as JSON.
+int runSingle(
+    const char* input_path, const char* resume_path, bool stats,
+    task::RevenuerManagerOptions options
+)
+{
+  std::string checkpoint;
+
+  if (resume_path != nullptr) {
+    std::ifstream file(resume_path, std::ios::binary);
+
+    if (!file) {
+      LOG_ERROR() << "Checkpoint file not found.";
+      return ERROR_FILE_NOT_FOUND;
+    }
+    checkpoint.assign(std::istreambuf_iterator<char>(file), {});
+  }
+
+  auto run = [&](task::RevenuerManager& manager) {
+    if (resume_path != nullptr && !manager.restore(checkpoint)) {
+      LOG_ERROR() << "Checkpoint does not match the input.";
+      return ERROR_INVALID_DATA;
+    }
+
+    try {
+      manager.process();
+    } catch (const std::runtime_error& e) {
+      std::cout << e.what() << '\n';
+    }
+
+    if (stats) {
+      manager.writeRunStats(std::cerr);
+    }
+    return ERROR_SUCCESS;
+  };
+
+  // The transcript goes straight to the descriptor, one write per flush.
+  auto output = task::OutputTarget::descriptor(STDOUT_FILENO);
+  task::MappedFile mapped(input_path);
+
+  if (mapped && task::isBinaryLog(mapped.view())) {
+    if (resume_path != nullptr || !options.checkpoint_path.empty() || stats) {
+      LOG_ERROR() << "Checkpoints and statistics need a text log.";
+      return ERROR_UNSUPPORTED;
+    }
+    return runBinary(mapped.view(), output, options);
+  }
+
+  if (mapped) {
+    task::RevenuerManager manager(mapped.view(), output, options);
+    return run(manager);
+  }
+
+  std::ifstream in(input_path);
+
+  if (!in) {
+    LOG_ERROR() << "Input file not found.";
+    return ERROR_FILE_NOT_FOUND;
+  }
+
+  task::RevenuerManager manager(in, output, options);
+
+  return run(manager);
+}
+
+// Prints the first offending line, as a run would, and nothing for a valid log.
+int runValidate(const char* input_path, std::size_t jobs)
+{
+  task::MappedFile mapped(input_path);
+  std::string copy;
+
+  if (!readFile(input_path, mapped, copy)) {
+    LOG_ERROR() << "Input file not found.";
+    return ERROR_FILE_NOT_FOUND;
+  }
+
+  auto input = mapped ? mapped.view() : std::string_view(copy);
+
+  if (task::isBinaryLog(input)) {
+    LOG_ERROR() << "Validation needs a text log.";
+    return ERROR_UNSUPPORTED;
+  }
+
+  std::string error_line;
+
+  if (!task::validateLog(input, jobs, error_line)) {
+    std::cout << error_line << '\n';
+    return ERROR_INVALID_DATA;
+  }
+
+  return ERROR_SUCCESS;
+}
+
+int runSections(
+    const char* input_path, std::size_t jobs, task::RevenuerManagerOptions options
+)
+{
+  auto output = task::OutputTarget::descriptor(STDOUT_FILENO);
+  task::MappedFile mapped(input_path);
+
+  if (mapped) {
+    task::processSections(mapped.view(), output, jobs, options);
+    return ERROR_SUCCESS;
+  }
+
+  std::ifstream in(input_path);
+
+  if (!in) {
+    LOG_ERROR() << "Input file not found.";
+    return ERROR_FILE_NOT_FOUND;
+  }
+
+  std::string input(std::istreambuf_iterator<char>(in), {});
+  task::processSections(input, output, jobs, options);
+
+  return ERROR_SUCCESS;
+}
+
+int runBatch(const char* pattern, std::size_t jobs, task::RevenuerManagerOptions options)
+{
+  auto inputs = task::collectBatchInputs(pattern);
+
+  if (inputs.empty()) {
+    LOG_ERROR() << "No input files found.";
+    return ERROR_FILE_NOT_FOUND;
+  }
+
+  auto results = task::runBatch(inputs, jobs, options);
+
+  task::writeBatchSummary(std::cout, results);
+
+  return ERROR_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc > 1 && std::string_view(argv[1]) == "convert") {
+    return argc == 4 ? runConvert(argv[2], argv[3]) : usage();
+  }
+
+  task::RevenuerManagerOptions options;
+  const char* input_path = nullptr;
+  const char* batch_pattern = nullptr;
+  const char* resume_path = nullptr;
+  bool sections = false;
+  bool validate = false;
+  bool stats = false;
+  std::size_t jobs = 0;
+
+  auto parse_count = [](std::string_view value, std::size_t& result) {
+    auto [end, code] = std::from_chars(value.begin(), value.end(), result);
+
+    return code == std::errc() && end == value.end();
+  };
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+
+    if (arg == "--stream") {
+      options.streaming = true;
+    } else if (arg == "--line-buffered") {
+      options.streaming = true;
+      options.flush_each_line = true;
+    } else if (arg == "--auto-assign") {
+      options.auto_assign = true;
+    } else if (arg == "--pipelined") {
+      options.pipelined = true;
+    } else if (arg == "--sections") {
+      sections = true;
+    } else if (arg == "--validate") {
+      validate = true;
+    } else if (arg == "--stats") {
+      stats = true;
+    } else if (arg == "--batch" && i + 1 < argc) {
+      batch_pattern = argv[++i];
+    } else if (arg == "--jobs" && i + 1 < argc) {
+      if (!parse_count(argv[++i], jobs)) {
+        return usage();
+      }
+    } else if (arg == "--checkpoint" && i + 1 < argc) {
+      options.checkpoint_path = argv[++i];
+    } else if (arg == "--checkpoint-every" && i + 1 < argc) {
+      if (!parse_count(argv[++i], options.checkpoint_every)) {
+        return usage();
+      }
+    } else if (arg == "--resume" && i + 1 < argc) {
+      resume_path = argv[++i];
+    } else if (input_path == nullptr && !arg.starts_with("--")) {
+      input_path = argv[i];
+    } else {
+      return usage();
+    }
+  }
+
+  // Checkpoints are written to the given file only.
+  if (options.checkpoint_every != 0 && options.checkpoint_path.empty()) {
+    return usage();
+  }
+
+  if (!options.checkpoint_path.empty()) {
+    // The transcript has to be written up to every checkpoint for a resumed run
+    // to append to it.
+    options.streaming = true;
+
+    if (options.checkpoint_every == 0) {
+      options.checkpoint_every = DEFAULT_CHECKPOINT_INTERVAL;
+    }
+  }
+
+  if ((batch_pattern != nullptr || sections || validate) &&
+      (!options.checkpoint_path.empty() || resume_path != nullptr || stats))
+  {
+    return usage();
+  }
+
+  if (validate && input_path != nullptr && batch_pattern == nullptr && !sections) {
+    return runValidate(input_path, jobs);
+  }
+
+  if (sections && input_path != nullptr && batch_pattern == nullptr) {
+    return runSections(input_path, jobs, options);
+  }
+
+  if (batch_pattern != nullptr && input_path == nullptr && !sections) {
+    return runBatch(batch_pattern, jobs, options);
+  }
+
+  if (input_path == nullptr || batch_pattern != nullptr || sections || validate ||
+      jobs != 0)
+  {
+    return usage();
+  }
+
+  return runSingle(input_path, resume_path, stats, options);
 }
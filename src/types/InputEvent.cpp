@@ -1,155 +1,68 @@
-#include <base_parser/BaseParser.hpp>
+#include <base_parser/Grammar.hpp>
 #include <types/InputEvent.hpp>
 
+#include <stdexcept>
+#include <string>
+
 namespace task {
 
 namespace {
 
-class EventParser : protected base_parser::BaseParser {
-  using base = base_parser::BaseParser;
-
-public:
-  explicit EventParser(std::string_view view) :
-      base(view)
-  {}
-
-  InputEvent parse()
-  {
-    InputEvent result = parseEvent();
-
-    if (!end()) {
-      throw error();
-    }
-
-    return result;
-  }
-
-private:
-  InputEvent parseEvent()
-  {
-    InputEvent result;
-
-    result.time = parseTime();
-    expect(' ');
-    result.type = parseType();
-    expect(' ');
-    result.client_id = parseClientID();
-
-    if (result.type == InputEvent::Type::CLIENT_TAKE_TABLE) {
-      expect(' ');
-      result.table_id = getNumber() - 1;
-    }
-
-    return result;
-  }
-
-  int parseTime()
-  {
-    int hour = parseHour();
-    expect(':');
-    int minute = parseMinute();
-
-    return hour * 60 + minute;
-  }
-
-  int parseHour()
-  {
-    int hour = parseFixedLengthNumber(2);
-
-    if (hour < 0 || hour > 23) {
-      throw error();
-    }
-
-    return hour;
-  }
-
-  int parseMinute()
-  {
-    int hour = parseFixedLengthNumber(2);
+using namespace base_parser;
 
-    if (hour < 0 || hour > 59) {
-      throw error();
-    }
+struct EventFields : InputEvent {
+  bool has_table;
+};
 
-    return hour;
-  }
+constexpr CharClass CLIENT_ID_CHARS("az09__--");
 
-  InputEvent::Type parseType()
-  {
-    int type = parseFixedLengthNumber(1);
+// "HH:MM <type> <client>[ <table>]" with single spaces, the table has no leading zeros.
+using EventGrammar = Grammar<
+    Clock<&EventFields::time>, Literal<' '>,
+    Digit<'1', '4', &EventFields::type>, Literal<' '>,
+    Run<CLIENT_ID_CHARS, &EventFields::client_id>,
+    Optional<&EventFields::has_table, Literal<' '>,
+             Number<&EventFields::table_id, 1u, LeadingZeros::FORBIDDEN>>,
+    End>;
 
-    if (type < 1 || type > 4) {
-      throw error();
-    }
+} // namespace
 
-    return static_cast<InputEvent::Type>(type);
-  }
+std::optional<InputEvent> InputEvent::tryGet(std::string_view view)
+{
+  EventFields fields;
 
-  std::string parseClientID()
+  // Only taking a table carries one.
+  if (!EventGrammar::parse(view, fields) ||
+      fields.has_table != (fields.type == Type::CLIENT_TAKE_TABLE))
   {
-    std::string result;
-
-    while (!test(' ') && !end()) {
-      if (between('a', 'z') || between('0', '9') || test('_') || test('-')) {
-        result.push_back(take());
-      } else {
-        throw error();
-      }
-    }
-
-    if (result.empty()) {
-      throw error();
-    }
-
-    return result;
+    return std::nullopt;
   }
 
-  int parseFixedLengthNumber(std::size_t length)
-  {
-    std::string str_num;
-    for (std::size_t i = 0; i < length; ++i) {
-      if (!between('0', '9')) {
-        throw error();
-      }
-      str_num.push_back(take());
-    }
-
-    try {
-      return std::stoi(str_num);
-    } catch (...) {
-      throw error();
-    }
+  if (fields.has_table) {
+    --fields.table_id;
   }
 
-  uint getNumber()
-  {
-    std::string str_num;
-
-    if (!between('1', '9')) {
-      throw error();
-    }
-
-    str_num.push_back(take());
+  return static_cast<InputEvent>(fields);
+}
 
-    while (between('0', '9')) {
-      str_num.push_back(take());
-    }
+InputEvent InputEvent::get(std::string_view view)
+{
+  auto result = tryGet(view);
 
-    try {
-      return std::stoul(str_num);
-    } catch (...) {
-      throw error();
-    }
+  if (!result.has_value()) {
+    throw std::runtime_error(std::string(lineAt(view, 0)));
   }
-};
 
-} // namespace
+  return *result;
+}
 
-InputEvent InputEvent::get(std::string_view view)
+bool InputEvent::validClientId(std::string_view client_id) noexcept
 {
-  EventParser parser(view);
+  struct Fields {
+    std::string_view client_id;
+  } fields;
 
-  return parser.parse();
+  return Grammar<Run<CLIENT_ID_CHARS, &Fields::client_id>, End>::parse(client_id, fields);
 }
 
 } // namespace task
@@ -1,120 +1,74 @@
-#include <base_parser/BaseParser.hpp>
+#include <base_parser/Grammar.hpp>
 #include <types/RevenuerManagerData.hpp>
 
+#include <stdexcept>
+#include <string>
+
 namespace task {
 
 namespace {
 
-class RevenuerManagerDataParser : protected base_parser::BaseParser {
-  using base = base_parser::BaseParser;
-
-public:
-  RevenuerManagerDataParser(std::string_view view) :
-      base(view)
-  {}
-
-  RevenuerManagerData parse()
-  {
-    RevenuerManagerData result;
-
-    result.table_count = parseUnsignedInt();
-
-    if (result.table_count < 1) {
-      throw error();
-    }
-
-    expect('\n');
-    result.begin_time = parseTime();
-    expect(' ');
-    result.end_time = parseTime();
-    expect('\n');
-    result.cost_per_hour = parseUnsignedInt();
-
-    if (result.cost_per_hour == 0) {
-      throw error();
-    }
-
-    return result;
-  }
-
-private:
-  unsigned int parseUnsignedInt()
-  {
-    std::string str_num;
-
-    if (!between('0', '9')) {
-      throw error();
-    }
-
-    str_num.push_back(take());
+using namespace base_parser;
 
-    while (between('0', '9')) {
-      str_num.push_back(take());
-    }
-
-    try {
-      return std::stoul(str_num);
-    } catch (...) {
-      throw std::runtime_error("Invalid unsigned int was parsed.");
-    }
-  }
+using Data = RevenuerManagerData;
 
-  int parseTime()
-  {
-    int hour = parseHour();
-    expect(':');
-    int minute = parseMinute();
+struct HeaderFields : Data {
+  bool overflow{false};
+};
 
-    return hour * 60 + minute;
-  }
+// Reported instead of the line for a number too large, as the header always did.
+constexpr std::string_view OVERFLOW_MESSAGE = "Invalid unsigned int was parsed.";
 
-  int parseHour()
+// A positive number that records whether it failed by overflowing, Number then
+// stops at the digit that did not fit.
+template<auto Member>
+struct HeaderNumber {
+  template<typename Result>
+  static constexpr bool parse(Cursor& cursor, Result& result) noexcept
   {
-    int hour = parseFixedLengthNumber(2);
-
-    if (hour < 0 || hour > 23) {
-      throw error();
+    if (Number<Member, 1u>::parse(cursor, result)) {
+      return true;
     }
-
-    return hour;
+    result.overflow = isDigit(cursor.peek());
+    return false;
   }
+};
 
-  int parseMinute()
-  {
-    int hour = parseFixedLengthNumber(2);
-
-    if (hour < 0 || hour > 59) {
-      throw error();
-    }
+// The table count, the opening and closing times and the cost per hour on lines of
+// their own. Leading zeros are fine here, anything after the cost is not looked at.
+using HeaderGrammar = Grammar<
+    HeaderNumber<&Data::table_count>, LiteralOrEnd<'\n'>,
+    Clock<&Data::begin_time>, Literal<' '>, Clock<&Data::end_time>, LiteralOrEnd<'\n'>,
+    HeaderNumber<&Data::cost_per_hour>>;
 
-    return hour;
-  }
+} // namespace
 
-  int parseFixedLengthNumber(std::size_t length)
-  {
-    std::string str_num;
-    for (std::size_t i = 0; i < length; ++i) {
-      if (!between('0', '9')) {
-        throw error();
-      }
-      str_num.push_back(take());
-    }
+std::optional<RevenuerManagerData>
+RevenuerManagerData::tryGet(std::string_view view, std::string_view* error_line) noexcept
+{
+  HeaderFields result;
+  std::size_t error_pos;
 
-    try {
-      return std::stoi(str_num);
-    } catch (...) {
-      throw error();
+  if (!HeaderGrammar::parse(view, result, &error_pos)) {
+    if (error_line != nullptr) {
+      *error_line = result.overflow ? OVERFLOW_MESSAGE : lineAt(view, error_pos);
     }
+    return std::nullopt;
   }
-};
 
-} // namespace
+  return static_cast<const RevenuerManagerData&>(result);
+}
 
 RevenuerManagerData RevenuerManagerData::get(std::string_view view)
 {
-  RevenuerManagerDataParser parser(view);
+  std::string_view error_line;
+  auto result = tryGet(view, &error_line);
+
+  if (!result.has_value()) {
+    throw std::runtime_error(std::string(error_line));
+  }
 
-  return parser.parse();
+  return *result;
 }
 
 } // namespace task
@@ -1,22 +1,60 @@
+#include <Batch.hpp>
+#include <BinaryLog.hpp>
+#include <Format.hpp>
+#include <FreeTableIndex.hpp>
+#include <OutputSink.hpp>
 #include <RevenuerManager.hpp>
-
+#include <Sections.hpp>
+#include <TableStore.hpp>
+#include <ThreadPool.hpp>
+#include <Validation.hpp>
+#include <WaitQueue.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <new>
 #include <sstream>
+#include <thread>
 
+#include <base_parser/Grammar.hpp>
+#include <base_parser/Scanner.hpp>
 #include <log.hpp>
+#include <unistd.h>
 
 namespace {
-std::string run(const std::string& input)
+std::atomic<std::uint64_t> allocation_count{0};
+} // namespace
+
+void* operator new(std::size_t size)
 {
-  std::stringstream in;
-  std::stringstream out;
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
 
-  in << input;
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
 
-  task::RevenuerManager manager(in, out);
+[[gnu::noinline]] void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+[[gnu::noinline]] void operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
 
+namespace {
+std::string process(task::RevenuerManager& manager, std::stringstream& out)
+{
   try {
     manager.process();
   } catch (const std::runtime_error& e) {
@@ -25,6 +63,27 @@ std::string run(const std::string& input)
 
   return out.str();
 }
+
+// Runs the input through both the stream and the in-memory readers, which must
+// produce the same output.
+std::string run(const std::string& input, task::RevenuerManagerOptions options = {})
+{
+  std::stringstream in;
+  std::stringstream out;
+
+  in << input;
+
+  task::RevenuerManager manager(in, out, options);
+
+  std::stringstream view_out;
+  task::RevenuerManager view_manager(std::string_view(input), view_out, options);
+
+  auto result = process(manager, out);
+
+  EXPECT_EQ(process(view_manager, view_out), result);
+
+  return result;
+}
 } // namespace
 
 TEST(Base, Example)
@@ -249,6 +308,27 @@ TEST(Syntax, OneDelimiterInEvent5)
   EXPECT_EQ(run(input), output);
 }
 
+TEST(Syntax, TableIDOverflow)
+{
+  std::string input = R"x(1
+09:00 21:00
+10
+09:00 1 client1
+10:00 2 client1 99999999999)x";
+
+  std::string output = "10:00 2 client1 99999999999";
+
+  EXPECT_EQ(run(input), output);
+}
+
+TEST(Syntax, HeaderNumberOverflow)
+{
+  // A number too large for the header is reported by message, not by line.
+  EXPECT_EQ(run("99999999999\n09:00 21:00\n10\n"), "Invalid unsigned int was parsed.");
+  EXPECT_EQ(run("1\n09:00 21:00\n4294967296\n"), "Invalid unsigned int was parsed.");
+  EXPECT_EQ(run("0\n09:00 21:00\n10\n"), "0");
+}
+
 TEST(Logic, TableIDOutOfRange)
 {
   std::string input = R"x(1
@@ -594,6 +674,78 @@ TEST(Logic, ClientLeave)
   EXPECT_EQ(run(input), output);
 }
 
+TEST(Logic, WaitingClientLeaves)
+{
+  std::string input = R"x(2
+09:00 21:00
+10
+09:00 1 a
+09:00 2 a 1
+09:01 1 d
+09:01 2 d 2
+09:10 1 b
+09:10 3 b
+09:20 1 c
+09:20 3 c
+09:30 4 b
+10:00 4 a
+)x";
+
+  std::string output = R"x(09:00
+09:00 1 a
+09:00 2 a 1
+09:01 1 d
+09:01 2 d 2
+09:10 1 b
+09:10 3 b
+09:20 1 c
+09:20 3 c
+09:30 4 b
+10:00 4 a
+10:00 12 c 1
+21:00 11 c
+21:00 11 d
+21:00
+1 120 12:00
+2 120 11:59
+)x";
+
+  EXPECT_EQ(run(input), output);
+}
+
+TEST(Logic, LeftWaitingClientFreesQueuePlace)
+{
+  std::string input = R"x(1
+09:00 21:00
+10
+09:00 1 a
+09:00 2 a 1
+09:10 1 b
+09:10 3 b
+09:20 4 b
+09:30 1 c
+09:30 3 c
+10:00 4 a
+)x";
+
+  std::string output = R"x(09:00
+09:00 1 a
+09:00 2 a 1
+09:10 1 b
+09:10 3 b
+09:20 4 b
+09:30 1 c
+09:30 3 c
+10:00 4 a
+10:00 12 c 1
+21:00 11 c
+21:00
+1 120 12:00
+)x";
+
+  EXPECT_EQ(run(input), output);
+}
+
 TEST(Logic, AlphabeticalOrder)
 {
   std::string input = R"x(3
@@ -628,6 +780,110 @@ TEST(Logic, AlphabeticalOrder)
   EXPECT_EQ(run(input), output);
 }
 
+TEST(Logic, ClosingOrderOfLongNames)
+{
+  // The names share a long prefix and some differ only past the first 8 bytes
+  // after it. The event after closing time runs once everybody has left.
+  std::string input = R"x(2
+09:00 10:00
+10
+09:10 1 client_0000000000b
+09:10 2 client_0000000000b 2
+09:20 1 client_0000000000
+09:20 1 client_00000000009
+09:20 1 client_0000000000a
+09:30 1 client_1
+09:30 2 client_1 1
+09:40 3 client_0000000000a
+10:30 1 late
+)x";
+
+  std::string output = R"x(09:00
+09:10 1 client_0000000000b
+09:10 2 client_0000000000b 2
+09:20 1 client_0000000000
+09:20 1 client_00000000009
+09:20 1 client_0000000000a
+09:30 1 client_1
+09:30 2 client_1 1
+09:40 3 client_0000000000a
+10:30 1 late
+10:00 11 client_0000000000
+10:00 11 client_00000000009
+10:00 11 client_0000000000a
+10:00 11 client_0000000000b
+10:00 11 client_1
+10:30 13 NotOpenYet
+10:00
+1 10 00:30
+2 10 00:50
+)x";
+
+  EXPECT_EQ(run(input), output);
+  EXPECT_EQ(run(input, {.streaming = true}), output);
+  EXPECT_EQ(run(input, {.pipelined = true}), output);
+}
+
+TEST(Logic, ClosingWithWaitingClients)
+{
+  // b sits down and c is still waiting when the empty line sends everybody away.
+  // The wait queue then starts over empty, so e takes the table d frees.
+  std::string input = R"x(2
+09:00 21:00
+10
+09:00 1 a
+09:00 2 a 1
+09:00 1 x
+09:00 2 x 2
+09:05 1 b
+09:05 3 b
+09:10 1 c
+09:10 3 c
+09:10 4 a
+
+09:20 1 d
+09:20 2 d 1
+09:20 1 f
+09:20 2 f 2
+09:25 1 e
+09:25 3 e
+09:30 4 d
+)x";
+
+  std::string output = R"x(09:00
+09:00 1 a
+09:00 2 a 1
+09:00 1 x
+09:00 2 x 2
+09:05 1 b
+09:05 3 b
+09:10 1 c
+09:10 3 c
+09:10 4 a
+09:10 12 b 1
+21:00 11 b
+21:00 11 c
+21:00 11 x
+09:20 1 d
+09:20 2 d 1
+09:20 1 f
+09:20 2 f 2
+09:25 1 e
+09:25 3 e
+09:30 4 d
+09:30 12 e 1
+21:00 11 e
+21:00 11 f
+21:00
+1 260 23:40
+2 240 23:40
+)x";
+
+  EXPECT_EQ(run(input), output);
+  EXPECT_EQ(run(input, {.streaming = true}), output);
+  EXPECT_EQ(run(input, {.pipelined = true}), output);
+}
+
 TEST(SuccessTests, Example1)
 {
   std::string input = R"x(1
@@ -654,6 +910,1217 @@ TEST(SuccessTests, Example1)
   EXPECT_EQ(run(input), output);
 }
 
+TEST(Syntax, TryProcessReportsLine)
+{
+  std::string input = R"x(1
+09:00 21:00
+10
+09:00 1 client1
+10:00 2 client1 5
+)x";
+
+  std::stringstream out;
+  task::RevenuerManager manager(std::string_view(input), out);
+
+  EXPECT_FALSE(manager.tryProcess());
+  EXPECT_EQ(manager.errorLine(), "10:00 2 client1 5");
+  EXPECT_EQ(out.str(), "");
+}
+
+TEST(Streaming, SameOutputAsBuffered)
+{
+  std::string input = R"x(3
+09:00 19:00
+10
+08:48 1 client1
+09:41 1 client1
+09:48 1 client2
+09:52 3 client1
+09:54 2 client1 1
+10:25 2 client2 2
+10:58 1 client3
+10:59 2 client3 3
+11:30 1 client4
+11:35 2 client4 2
+11:45 3 client4
+12:33 4 client1
+12:43 4 client2
+15:52 4 client4
+)x";
+
+  for (std::size_t buffer_size : {1, 16, 1 << 16}) {
+    task::RevenuerManagerOptions options{
+        .streaming = true, .stream_buffer_size = buffer_size};
+
+    EXPECT_EQ(run(input, options), run(input));
+  }
+}
+
+TEST(Streaming, AcceptedLinesBeforeError)
+{
+  std::string input = R"x(1
+09:00 21:00
+10
+10:00 1 client1
+09:59 2 client1 1)x";
+
+  std::string output = R"x(09:00
+10:00 1 client1
+09:59 2 client1 1)x";
+
+  task::RevenuerManagerOptions options{.streaming = true, .stream_buffer_size = 1};
+
+  EXPECT_EQ(run(input, options), output);
+}
+
+TEST(Streaming, PipelinedSameAsSequential)
+{
+  // Long enough to wrap the pipeline's rings, with every kind of generated event.
+  std::string long_input = "3\n09:00 20:00\n10\n";
+
+  for (int minute = 0; minute < 600; ++minute) {
+    std::string clock(task::clockOfDay(9 * 60 + minute));
+    auto client = "c" + std::to_string(minute);
+
+    long_input += clock + " 1 " + client + '\n';
+    long_input += clock + " 2 " + client + ' ' + std::to_string(minute % 3 + 1) + '\n';
+    long_input += clock + " 3 " + client + '\n';
+    long_input += clock + " 4 c" + std::to_string(minute / 2) + '\n';
+  }
+
+  std::vector<std::string> inputs = {
+      long_input,
+      // Deferred past closing time.
+      "1\n09:00 21:00\n10\n10:00 1 a\n10:00 2 a 1\n21:30 1 b\n",
+      // Read on after an empty line while clients are left.
+      "1\n09:00 21:00\n10\n10:00 1 a\n\n22:00 1 b\n",
+      "1\n09:00 21:00\n10\n10:00 1 a\n10:01 2 a 2\n10:02 1 b\n",
+      "1\n09:00 21:00\n10\n10:00 1 a\n09:59 2 a 1\n",
+      "1\n09:00 21:00\n10\n10:00 1 a\n10:0 1 b\n",
+  };
+
+  for (const auto& input : inputs) {
+    for (bool streaming : {false, true}) {
+      task::RevenuerManagerOptions options{
+          .streaming = streaming, .stream_buffer_size = 1};
+
+      std::stringstream out;
+      task::RevenuerManagerOptions pipelined_options = options;
+
+      pipelined_options.pipelined = true;
+
+      task::RevenuerManager manager(std::string_view(input), out, pipelined_options);
+
+      EXPECT_EQ(process(manager, out), run(input, options));
+    }
+  }
+}
+
+TEST(Streaming, FlushPolicy)
+{
+  std::string input = R"x(1
+09:00 21:00
+10
+10:00 1 client1
+10:01 2 client1 1
+10:02 3 client1
+)x";
+
+  auto write_count = [&input](task::RevenuerManagerOptions options) {
+    std::stringstream out;
+    task::RevenuerManager manager(std::string_view(input), out, options);
+
+    manager.process();
+
+    return manager.outputWriteCount();
+  };
+
+  EXPECT_EQ(write_count({}), 1);
+  EXPECT_EQ(write_count({.streaming = true}), 1);
+  // Opening time, three events, the leave at closing, closing time and the table.
+  EXPECT_EQ(write_count({.streaming = true, .flush_each_line = true}), 7);
+}
+
+TEST(Streaming, DescriptorSink)
+{
+  std::array<int, 2> pipe_fds;
+
+  ASSERT_EQ(::pipe(pipe_fds.data()), 0);
+
+  {
+    task::OutputSink sink(
+        task::OutputTarget::descriptor(pipe_fds[1]), task::OutputSink::FlushPolicy::THRESHOLD,
+        8
+    );
+
+    sink.buffer() += "09:00\n";
+    sink.commit();
+    EXPECT_EQ(sink.writeCount(), 0);
+
+    sink.buffer() += "10:00 1 a\n";
+    sink.commit();
+    EXPECT_EQ(sink.writeCount(), 1);
+    EXPECT_TRUE(sink.good());
+  }
+  ::close(pipe_fds[1]);
+
+  std::array<char, 64> data;
+  auto size = ::read(pipe_fds[0], data.data(), data.size());
+  ::close(pipe_fds[0]);
+
+  EXPECT_EQ(std::string_view(data.data(), size), "09:00\n10:00 1 a\n");
+}
+
+TEST(Live, FeedMatchesProcess)
+{
+  std::string input = R"x(3
+09:00 19:00
+10
+08:48 1 client1
+09:41 1 client1
+09:48 1 client2
+09:52 3 client1
+09:54 2 client1 1
+10:25 2 client2 2
+10:58 1 client3
+10:59 2 client3 3
+11:30 1 client4
+11:35 2 client4 2
+11:45 3 client4
+12:33 4 client1
+12:43 4 client2
+)x";
+
+  std::vector<std::string> lines;
+  std::stringstream in(input);
+
+  for (std::string line; std::getline(in, line);) {
+    lines.push_back(line);
+  }
+
+  auto data = task::RevenuerManagerData::get(lines[0] + '\n' + lines[1] + '\n' + lines[2]);
+  std::stringstream out;
+  task::RevenuerManager manager(data, out);
+
+  for (std::size_t i = 3; i < lines.size(); ++i) {
+    EXPECT_TRUE(manager.feed(task::InputEvent::get(lines[i])));
+  }
+  manager.finish();
+
+  EXPECT_EQ(out.str(), run(input));
+}
+
+TEST(Live, Queries)
+{
+  std::stringstream out;
+  task::RevenuerManager manager(
+      task::RevenuerManagerData{
+          .table_count = 2, .begin_time = 9 * 60, .end_time = 21 * 60, .cost_per_hour = 10},
+      out
+  );
+
+  for (auto line :
+       {"09:00 1 a", "09:00 2 a 1", "09:10 1 b", "09:10 2 b 2", "09:20 1 c", "09:20 3 c"})
+  {
+    ASSERT_TRUE(manager.feed(task::InputEvent::get(line)));
+  }
+
+  EXPECT_EQ(manager.currentTime(), 9 * 60 + 20);
+  EXPECT_EQ(manager.clientCount(), 3);
+  EXPECT_EQ(manager.queueLength(), 1);
+  EXPECT_EQ(manager.clientTable("a"), 0);
+  EXPECT_EQ(manager.clientTable("c"), std::nullopt);
+  EXPECT_EQ(manager.clientTable("d"), std::nullopt);
+  EXPECT_EQ(manager.tableOccupant(1), "b");
+  EXPECT_EQ(manager.busySince(0), 9 * 60);
+
+  auto accrued = manager.accruedStatistic(0, 9 * 60 + 20);
+  EXPECT_EQ(accrued.revenue, 10);
+  EXPECT_EQ(accrued.used_time, 20);
+
+  // The waiting client takes the table that was freed.
+  ASSERT_TRUE(manager.feed(task::InputEvent::get("10:30 4 a")));
+
+  EXPECT_EQ(manager.tableOccupant(0), "c");
+  EXPECT_EQ(manager.busySince(0), 10 * 60 + 30);
+  EXPECT_EQ(manager.queueLength(), 0);
+  EXPECT_EQ(manager.tables().statistic(0).revenue, 20);
+
+  accrued = manager.accruedStatistic(0, 10 * 60 + 31);
+  EXPECT_EQ(accrued.revenue, 30);
+  EXPECT_EQ(accrued.used_time, 91);
+
+  // A session has earned nothing before it started.
+  accrued = manager.accruedStatistic(0, 10 * 60);
+  EXPECT_EQ(accrued.revenue, 20);
+  EXPECT_EQ(accrued.used_time, 90);
+
+  for (task::TableID table : {-1, 2}) {
+    EXPECT_EQ(manager.tableOccupant(table), std::nullopt);
+    EXPECT_EQ(manager.busySince(table), std::nullopt);
+    EXPECT_EQ(manager.accruedStatistic(table, 11 * 60).revenue, 0);
+  }
+
+  EXPECT_FALSE(manager.feed(task::InputEvent::get("10:00 1 d")));
+  EXPECT_EQ(manager.errorLine(), "10:00 1 d");
+
+  // A rejected event leaves the clock where it was.
+  EXPECT_FALSE(manager.feed(task::InputEvent::get("11:00 2 c 3")));
+  EXPECT_EQ(manager.errorLine(), "11:00 2 c 3");
+  EXPECT_EQ(manager.currentTime(), 10 * 60 + 30);
+}
+
+TEST(Checkpoint, ResumeMatchesFullRun)
+{
+  std::string input = R"x(3
+09:00 19:00
+10
+08:48 1 client1
+09:41 1 client1
+09:48 1 client2
+09:52 3 client1
+09:54 2 client1 1
+10:25 2 client2 2
+10:58 1 client3
+10:59 2 client3 3
+11:30 1 client4
+11:35 2 client4 2
+11:45 3 client4
+12:33 4 client1
+12:43 4 client2
+19:30 1 client5
+)x";
+
+  auto path = std::filesystem::temp_directory_path() / "task_checkpoint_test.bin";
+  task::RevenuerManagerOptions options{.streaming = true, .stream_buffer_size = 16};
+  std::stringstream full;
+
+  task::RevenuerManager(std::string_view(input), full, options).process();
+
+  for (std::size_t every = 1; every <= 14; ++every) {
+    options.checkpoint_every = every;
+    options.checkpoint_path = path.string();
+
+    std::stringstream ignored;
+    task::RevenuerManager(std::string_view(input), ignored, options).process();
+
+    std::ifstream file(path, std::ios::binary);
+    std::string checkpoint(std::istreambuf_iterator<char>(file), {});
+
+    options.checkpoint_every = 0;
+
+    std::stringstream in(input);
+    std::stringstream stream_out;
+    task::RevenuerManager stream_manager(in, stream_out, options);
+
+    std::stringstream view_out;
+    task::RevenuerManager view_manager(std::string_view(input), view_out, options);
+
+    ASSERT_TRUE(stream_manager.restore(checkpoint));
+    ASSERT_TRUE(view_manager.restore(checkpoint));
+
+    auto prefix = full.str().substr(0, view_manager.outputOffset());
+
+    stream_manager.process();
+    view_manager.process();
+
+    EXPECT_EQ(prefix + stream_out.str(), full.str()) << every;
+    EXPECT_EQ(prefix + view_out.str(), full.str()) << every;
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST(Checkpoint, RejectsMalformed)
+{
+  std::string input = "1\n09:00 21:00\n10\n10:00 1 a\n10:01 2 a 1\n";
+  std::stringstream out;
+  task::RevenuerManager manager(std::string_view(input), out);
+
+  manager.process();
+
+  std::string checkpoint;
+  manager.checkpoint(checkpoint);
+
+  std::stringstream resumed_out;
+
+  EXPECT_FALSE(task::RevenuerManager(std::string_view(input), resumed_out).restore("GRCP"));
+  EXPECT_FALSE(task::RevenuerManager(std::string_view(input), resumed_out)
+                   .restore(checkpoint.substr(0, checkpoint.size() - 1)));
+  // The input is shorter than the checkpointed offset.
+  EXPECT_FALSE(task::RevenuerManager(std::string_view("1\n"), resumed_out).restore(checkpoint));
+  EXPECT_TRUE(task::RevenuerManager(std::string_view(input), resumed_out).restore(checkpoint));
+
+  // Another input of the same length.
+  std::string other = input;
+  other[other.find('a')] = 'b';
+  EXPECT_FALSE(task::RevenuerManager(std::string_view(other), resumed_out).restore(checkpoint));
+
+  std::stringstream other_stream(other);
+  EXPECT_FALSE(task::RevenuerManager(other_stream, resumed_out).restore(checkpoint));
+
+  // Overwrites the 32-bit field at `offset`, little-endian.
+  auto patched = [&checkpoint](std::size_t offset, std::uint32_t value) {
+    auto result = checkpoint;
+
+    for (std::size_t i = 0; i < 4; ++i) {
+      result[offset + i] = static_cast<char>(value >> (8 * i));
+    }
+    return result;
+  };
+
+  // A pending leave of `a`, who is gone: time, type, client, table, error.
+  auto pending = checkpoint;
+  pending.back() = 1;
+  pending += std::string("\x5a\x02\0\0\x0b\0\0\0\0\0\0\0\0\0", 14);
+  EXPECT_FALSE(task::RevenuerManager(std::string_view(input), resumed_out).restore(pending));
+
+  constexpr std::size_t TABLE_COUNT = 8;
+  constexpr std::size_t BEGIN_TIME = 12;
+  constexpr std::size_t END_TIME = 16;
+  constexpr std::size_t COST = 20;
+  constexpr std::size_t INPUT_OFFSET = 24;
+  constexpr std::size_t LAST_TIME = 48;
+
+  for (auto [offset, value] : std::vector<std::pair<std::size_t, std::uint32_t>>{
+           {TABLE_COUNT, 0},
+           {BEGIN_TIME, 24 * 60},
+           {END_TIME, static_cast<std::uint32_t>(-1)},
+           {COST, 0},
+           {LAST_TIME, 24 * 60},
+           {LAST_TIME, static_cast<std::uint32_t>(-2)},
+           // Within the last line.
+           {INPUT_OFFSET, static_cast<std::uint32_t>(input.size() - 2)},
+       })
+  {
+    EXPECT_FALSE(task::RevenuerManager(std::string_view(input), resumed_out)
+                     .restore(patched(offset, value)))
+        << offset << " " << value;
+  }
+}
+
+TEST(BinaryLog, SameTranscriptAsText)
+{
+  std::vector<std::string> inputs = {
+      R"x(3
+09:00 19:00
+10
+08:48 1 client1
+09:41 1 client1
+09:48 1 client2
+09:52 3 client1
+09:54 2 client1 1
+10:25 2 client2 2
+10:58 1 client3
+10:59 2 client3 3
+11:30 1 client4
+11:35 2 client4 2
+11:45 3 client4
+12:33 4 client1
+12:43 4 client2
+19:30 1 client1
+)x",
+      // Rejected by the manager, not by the parser.
+      "1\n09:00 21:00\n10\n10:00 1 a\n10:01 2 a 2\n",
+  };
+
+  for (const auto& input : inputs) {
+    std::string binary;
+    std::string error_line;
+
+    ASSERT_TRUE(task::textToBinaryLog(input, binary, error_line));
+    EXPECT_TRUE(task::isBinaryLog(binary));
+    EXPECT_LT(binary.size(), input.size());
+
+    std::string text;
+
+    ASSERT_TRUE(task::binaryLogToText(binary, text));
+    EXPECT_EQ(text, input);
+
+    std::string output;
+
+    if (!task::processBinaryLog(
+            binary, task::OutputTarget::appendTo(output), {}, error_line
+        ))
+    {
+      output += error_line;
+    }
+    EXPECT_EQ(output, run(input));
+  }
+}
+
+TEST(BinaryLog, RejectsMalformed)
+{
+  std::string binary;
+  std::string error_line;
+
+  EXPECT_FALSE(task::textToBinaryLog(
+      "1\n09:00 21:00\n10\n10:00 1 a\n10:01 7 a\n", binary, error_line
+  ));
+  EXPECT_EQ(error_line, "10:01 7 a");
+
+  ASSERT_TRUE(
+      task::textToBinaryLog("1\n09:00 21:00\n10\n10:00 1 a\n", binary, error_line)
+  );
+
+  std::string text;
+  std::string output;
+
+  EXPECT_FALSE(task::binaryLogToText(binary.substr(0, binary.size() - 1), text));
+  EXPECT_FALSE(task::processBinaryLog(
+      binary.substr(0, binary.size() - 1), task::OutputTarget::appendTo(output), {},
+      error_line
+  ));
+  EXPECT_TRUE(error_line.empty());
+  EXPECT_TRUE(output.empty());
+
+  // Names are spelled as in the event lines.
+  auto bad_name = binary;
+  bad_name[bad_name.find('a')] = 'A';
+  EXPECT_FALSE(task::binaryLogToText(bad_name, text));
+}
+
+TEST(BinaryLog, EmptyLine)
+{
+  std::string binary;
+  std::string error_line;
+  std::string text;
+
+  // Nobody is in the club, a run stops at the empty line.
+  ASSERT_TRUE(task::textToBinaryLog(
+      "1\n09:00 21:00\n10\n10:00 1 a\n10:05 4 a\n\n10:10 1 b\n", binary, error_line
+  ));
+  ASSERT_TRUE(task::binaryLogToText(binary, text));
+  EXPECT_EQ(text, "1\n09:00 21:00\n10\n10:00 1 a\n10:05 4 a\n");
+
+  // A run sends `a` away and reads on, which a binary log cannot hold.
+  EXPECT_FALSE(task::textToBinaryLog(
+      "1\n09:00 21:00\n10\n10:00 1 a\n\n\n10:10 1 b\n", binary, error_line
+  ));
+  EXPECT_EQ(error_line, "10:10 1 b");
+
+  // Trailing empty lines are fine either way.
+  EXPECT_TRUE(
+      task::textToBinaryLog("1\n09:00 21:00\n10\n10:00 1 a\n\n\n", binary, error_line)
+  );
+}
+
+TEST(Scanner, FindAcrossBlocks)
+{
+  std::string data(100, 'a');
+
+  for (std::size_t pos : {0, 15, 16, 31, 32, 47, 63, 64, 99}) {
+    data[pos] = '\n';
+    EXPECT_EQ(base_parser::find(data, '\n'), pos);
+    EXPECT_EQ(base_parser::find(data, '\n', pos + 1), data.size());
+    data[pos] = 'a';
+  }
+}
+
+namespace {
+
+struct Reading {
+  int time;
+  unsigned int value;
+  bool has_value;
+};
+
+using ReadingGrammar = base_parser::Grammar<
+    base_parser::Clock<&Reading::time>,
+    base_parser::Optional<
+        &Reading::has_value, base_parser::Literal<'='>,
+        base_parser::Number<&Reading::value, 1u, base_parser::LeadingZeros::FORBIDDEN>>,
+    base_parser::End>;
+
+constexpr bool parsesReading(std::string_view text)
+{
+  Reading reading{};
+  return ReadingGrammar::parse(text, reading);
+}
+
+static_assert(parsesReading("10:00") && parsesReading("10:00=42"));
+static_assert(!parsesReading("10:00=") && !parsesReading("10:00=042"));
+static_assert(!parsesReading("10:00=0") && !parsesReading("10:00 "));
+
+} // namespace
+
+TEST(Grammar, ReportsOffendingPosition)
+{
+  Reading reading{};
+  std::size_t error_pos = 0;
+
+  ASSERT_TRUE(ReadingGrammar::parse("23:59=7", reading, &error_pos));
+  EXPECT_EQ(reading.time, 23 * 60 + 59);
+  EXPECT_TRUE(reading.has_value);
+  EXPECT_EQ(reading.value, 7);
+
+  EXPECT_FALSE(ReadingGrammar::parse("10:00=99999999999", reading, &error_pos));
+  EXPECT_EQ(error_pos, 15);
+  EXPECT_FALSE(ReadingGrammar::parse("10:00x", reading, &error_pos));
+  EXPECT_EQ(error_pos, 5);
+
+  std::string_view text = "3\n09:00 19:00\n\n";
+  EXPECT_EQ(base_parser::lineAt(text, 0), "3");
+  EXPECT_EQ(base_parser::lineAt(text, 1), "3");
+  EXPECT_EQ(base_parser::lineAt(text, 7), "09:00 19:00");
+  EXPECT_EQ(base_parser::lineAt(text, 14), "");
+  EXPECT_EQ(base_parser::lineAt(text, 100), "");
+  EXPECT_EQ(base_parser::lineAt("", 0), "");
+}
+
+TEST(Logic, AutoAssign)
+{
+  std::string input = R"x(3
+09:00 21:00
+10
+09:00 1 nikita
+09:00 2 nikita 1
+09:10 1 seva
+09:10 3 seva
+09:20 4 nikita
+)x";
+
+  std::string output = R"x(09:00
+09:00 1 nikita
+09:00 2 nikita 1
+09:10 1 seva
+09:10 3 seva
+09:10 12 seva 2
+09:20 4 nikita
+21:00 11 seva
+21:00
+1 10 00:20
+2 120 11:50
+3 0 00:00
+)x";
+
+  EXPECT_EQ(run(input, task::RevenuerManagerOptions{.auto_assign = true}), output);
+}
+
+TEST(FreeTables, FindAcrossWords)
+{
+  task::FreeTableIndex index(10'000);
+
+  EXPECT_EQ(index.count(), 10'000);
+  EXPECT_EQ(index.first(), 0);
+
+  for (std::size_t table = 0; table < 9'000; ++table) {
+    index.setBusy(table);
+  }
+
+  EXPECT_EQ(index.count(), 1'000);
+  EXPECT_EQ(index.first(), 9'000);
+  EXPECT_EQ(index.next(9'999), 9'999);
+
+  index.setFree(4'100);
+  EXPECT_EQ(index.first(), 4'100);
+  EXPECT_EQ(index.next(4'101), 9'000);
+  EXPECT_TRUE(index.isFree(4'100));
+  EXPECT_FALSE(index.isFree(4'101));
+
+  for (std::size_t table = 9'000; table < 10'000; ++table) {
+    index.setBusy(table);
+  }
+  index.setBusy(4'100);
+
+  EXPECT_EQ(index.count(), 0);
+  EXPECT_EQ(index.first(), task::FreeTableIndex::NONE);
+  EXPECT_EQ(index.next(10'000), task::FreeTableIndex::NONE);
+}
+
+TEST(TableStore, ReleaseAllMatchesOneByOne)
+{
+  // Not a whole number of SIMD registers, with a large cost to cover the 32-bit
+  // products.
+  constexpr std::size_t TABLE_COUNT = 37;
+  constexpr uint COST = 3'000'000'000u;
+  constexpr int CLOSING_TIME = task::MINUTES_PER_DAY - 1;
+
+  task::TableStore bulk(TABLE_COUNT);
+  task::TableStore single(TABLE_COUNT);
+
+  for (std::size_t table = 0; table < TABLE_COUNT; ++table) {
+    if (table % 3 != 0) {
+      int since = static_cast<int>(table * 97 % task::MINUTES_PER_DAY);
+
+      bulk.occupy(table, since);
+      single.occupy(table, since);
+    }
+  }
+  bulk.occupy(1, 0);
+  single.occupy(1, 0);
+
+  EXPECT_EQ(bulk.summary().busy_tables, 24);
+
+  bulk.releaseAll(CLOSING_TIME, COST);
+
+  for (std::size_t table = 0; table < TABLE_COUNT; ++table) {
+    if (single.busySince(table) != task::TableStore::FREE) {
+      single.release(table, CLOSING_TIME, COST);
+    }
+
+    EXPECT_EQ(bulk.busySince(table), task::TableStore::FREE);
+    EXPECT_EQ(bulk.statistic(table).revenue, single.statistic(table).revenue);
+    EXPECT_EQ(bulk.statistic(table).used_time, single.statistic(table).used_time);
+  }
+
+  EXPECT_EQ(bulk.statistic(1).revenue, 24 * COST);
+  EXPECT_EQ(bulk.statistic(1).used_time, CLOSING_TIME);
+  EXPECT_EQ(bulk.statistic(3).used_time, 0);
+}
+
+TEST(TableStore, SummariesOfManyClubs)
+{
+  std::vector<task::TableStore> stores;
+  task::TableSummary expected;
+
+  for (std::size_t club = 0; club < 50; ++club) {
+    auto& store = stores.emplace_back(club * 11 + 1);
+
+    for (std::size_t table = 0; table < store.size(); ++table) {
+      store.occupy(table, 0);
+      store.release(table, static_cast<int>(table % 120), 4'000'000'000u);
+
+      expected.revenue += store.statistic(table).revenue;
+      expected.used_time += store.statistic(table).used_time;
+    }
+    store.occupy(0, 0);
+    ++expected.busy_tables;
+  }
+
+  std::vector<const task::TableStore*> clubs;
+
+  for (auto& store : stores) {
+    clubs.push_back(&store);
+  }
+
+  for (std::size_t jobs : {1, 4}) {
+    auto total = task::summarizeClubs(clubs, jobs);
+
+    EXPECT_EQ(total.revenue, expected.revenue);
+    EXPECT_EQ(total.used_time, expected.used_time);
+    EXPECT_EQ(total.busy_tables, expected.busy_tables);
+  }
+}
+
+TEST(WaitQueue, RemoveFromAnywhere)
+{
+  task::WaitQueue queue(3);
+
+  auto first = queue.push(10);
+  auto second = queue.push(20);
+  auto third = queue.push(30);
+
+  EXPECT_TRUE(queue.full());
+
+  queue.remove(second);
+  EXPECT_EQ(queue.size(), 2);
+  EXPECT_FALSE(queue.full());
+
+  queue.push(40);
+  EXPECT_EQ(queue.front(), 10);
+
+  queue.remove(first);
+  EXPECT_EQ(queue.front(), 30);
+
+  queue.remove(third);
+  EXPECT_EQ(queue.front(), 40);
+
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(Parallel, EveryIndexOnce)
+{
+  task::ThreadPool pool(4);
+  std::vector<std::atomic<int>> calls(1000);
+
+  for (int round = 0; round < 3; ++round) {
+    pool.parallelFor(calls.size(), [&](std::size_t i) {
+      ++calls[i];
+    });
+  }
+
+  for (auto& count : calls) {
+    EXPECT_EQ(count, 3);
+  }
+}
+
+TEST(Parallel, UnevenLoopsOfAnySize)
+{
+  task::ThreadPool pool(4);
+
+  // Fewer indices than threads, and loops where the first share is far slower than
+  // the rest so that it has to be stolen from.
+  for (std::size_t count : {1, 3, 4, 97, 1000}) {
+    std::vector<std::atomic<int>> calls(count);
+
+    pool.parallelFor(count, [&](std::size_t i) {
+      if (i < count / 4) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+      ++calls[i];
+    });
+
+    for (auto& call_count : calls) {
+      EXPECT_EQ(call_count, 1);
+    }
+  }
+}
+
+TEST(Parallel, SectionsKeepInputOrder)
+{
+  std::vector<std::string> inputs = {
+      "1\n09:00 21:00\n10\n10:00 1 a\n10:01 2 a 1\n",
+      "2\n08:00 20:00\n5\n08:30 1 b\n08:31 2 b 2\n09:00 4 b\n",
+      "1\n09:00 21:00\n10\n10:00 1 a\n09:00 1 c\n",
+      "3\n10:00 22:00\n7\n11:00 1 c\n11:05 3 c\n",
+  };
+
+  std::string input;
+  std::string expected;
+
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    input += inputs[i];
+    // The first empty line sends the clients still there away, the second one ends
+    // the section. Extra empty lines between sections are skipped.
+    input += i == 1 ? "\n\n\n" : "\n\n";
+
+    if (i > 0) {
+      expected += '\n';
+    }
+    expected += run(inputs[i]);
+    if (!expected.ends_with('\n')) {
+      expected += '\n';
+    }
+  }
+
+  for (std::size_t jobs : {1, 3}) {
+    std::string output;
+
+    EXPECT_EQ(task::processSections(input, task::OutputTarget::appendTo(output), jobs), 1);
+    EXPECT_EQ(output, expected);
+  }
+}
+
+TEST(Parallel, SectionsEndWhereTheRunStops)
+{
+  // `a` is still there at the first empty line, so the day goes on. Nobody is at
+  // the second one, which starts the next section.
+  std::string first = "1\n09:00 21:00\n10\n10:00 1 a\n\n11:00 1 b\n11:30 4 b\n";
+  std::string second = "2\n08:00 20:00\n5\n08:30 1 c\n";
+  std::string input = first + "\n" + second;
+
+  for (std::size_t jobs : {1, 3}) {
+    std::string output;
+
+    EXPECT_EQ(task::processSections(input, task::OutputTarget::appendTo(output), jobs), 0);
+    EXPECT_EQ(output, run(first) + "\n" + run(second));
+  }
+
+  // A section that stops at its offending line is followed by the next one that
+  // starts after an empty line.
+  std::string bad = "1\n09:00 21:00\n10\n10:00 1 a\n\nbad\n10:05 1 b\n";
+  std::string output;
+
+  input = bad + "\n" + second;
+
+  EXPECT_EQ(task::processSections(input, task::OutputTarget::appendTo(output), 2), 1);
+  EXPECT_EQ(output, "bad\n\n" + run(second));
+}
+
+TEST(Parallel, BatchIsolatesBadFiles)
+{
+  auto directory = std::filesystem::temp_directory_path() / "task_batch_test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  std::string good = R"x(1
+09:00 21:00
+10
+09:00 1 client1
+10:00 2 client1 1
+)x";
+  std::string bad = R"x(1
+09:00 21:00
+10
+10:00 1 client1
+09:59 2 client1 1
+)x";
+
+  std::ofstream(directory / "a.txt") << good;
+  std::ofstream(directory / "b.txt") << bad;
+  std::ofstream(directory / "c.txt") << good;
+
+  auto inputs = task::collectBatchInputs(directory.string());
+  ASSERT_EQ(inputs.size(), 3);
+
+  auto results = task::runBatch(inputs, 2);
+  ASSERT_EQ(results.size(), 3);
+
+  for (std::size_t i : {0, 2}) {
+    EXPECT_TRUE(results[i].success);
+    EXPECT_EQ(results[i].revenue, 110);
+    EXPECT_EQ(results[i].used_time, 11 * 60);
+
+    std::ifstream output(results[i].output_path);
+    std::stringstream content;
+    content << output.rdbuf();
+    EXPECT_EQ(content.str(), run(good));
+  }
+
+  EXPECT_FALSE(results[1].success);
+  EXPECT_EQ(results[1].error, "09:59 2 client1 1");
+
+  // Outputs of this run are not picked up as inputs of the next one.
+  EXPECT_EQ(task::collectBatchInputs(directory.string()).size(), 3);
+  EXPECT_EQ(task::collectBatchInputs((directory / "*.txt").string()).size(), 3);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(Validation, SameLineAsRun)
+{
+  std::vector<std::string> inputs = {
+      "1\n09:00 21:00\n",
+      "1\n09:00 21:00\n0\n",
+      "1\n09:00 21:00\n10\n10:00 1 a\n10:0 1 b\n",
+      "1\n09:00 21:00\n10\n10:00 1 a\n09:59 2 a 1\n",
+      "1\n09:00 21:00\n10\n10:00 1 a\n10:01 2 a 2\n10:02 1 b\n",
+      "1\n09:00 21:00\n10\n10:00 1 a\n10:00 5 a\n",
+  };
+
+  for (const auto& input : inputs) {
+    std::string error_line;
+
+    EXPECT_FALSE(task::validateLog(input, 2, error_line));
+    EXPECT_EQ(error_line, run(input)) << input;
+  }
+
+  std::string error_line;
+
+  // The day ends at an empty line with nobody in the club.
+  EXPECT_TRUE(task::validateLog("1\n09:00 21:00\n10\n10:00 1 a\n10:05 4 a\n\nx\n", 2, error_line));
+
+  // Otherwise the clients are sent away and the log goes on.
+  for (std::string input : {
+           "2\n09:00 19:00\n10\n10:00 1 a\n\n11:00 1 b\nbad line\n",
+           "1\n09:00 21:00\n10\n10:00 1 a\n\n09:00 1 b\n",
+       })
+  {
+    EXPECT_FALSE(task::validateLog(input, 2, error_line));
+    EXPECT_EQ(error_line, run(input)) << input;
+  }
+}
+
+TEST(Validation, FirstOffendingLineOfAnyChunk)
+{
+  // Big enough to be split into several chunks.
+  std::vector<std::string> lines;
+
+  for (int i = 0; i < 24'000; ++i) {
+    lines.push_back(
+        std::string(task::clockOfDay(9 * 60 + i / 40)) + " 1 c" + std::to_string(i)
+    );
+  }
+
+  auto join = [&lines]() {
+    std::string input = "3\n09:00 21:00\n10\n";
+
+    for (const auto& line : lines) {
+      input += line;
+      input += '\n';
+    }
+    return input;
+  };
+
+  std::string error_line;
+  auto input = join();
+
+  ASSERT_TRUE(task::validateLog(input, 4, error_line));
+
+  std::size_t events_size = input.size() - std::string_view("3\n09:00 21:00\n10\n").size();
+
+  // The first line past every fraction of the events, where a chunk of that many
+  // starts.
+  for (std::size_t parts = 2; parts <= 8; ++parts) {
+    for (std::size_t part = 1; part < parts; ++part) {
+      std::size_t line = 0;
+
+      for (std::size_t offset = 0; offset < events_size * part / parts; ++line) {
+        offset += lines[line].size() + 1;
+      }
+
+      for (auto bad : {std::string("09:00 1 late"), std::string("10:00 1 bad!"),
+                       std::string("20:00 2 c0 11")})
+      {
+        auto original = lines[line];
+
+        lines[line] = bad;
+        input = join();
+        lines[line] = original;
+
+        EXPECT_FALSE(task::validateLog(input, 4, error_line));
+        EXPECT_EQ(error_line, bad);
+      }
+    }
+  }
+}
+
+TEST(Stats, CountsEvents)
+{
+  if constexpr (!task::STATS_ENABLED) {
+    GTEST_SKIP() << "Built without ENABLE_STATS";
+  }
+
+  std::string input = R"x(3
+09:00 19:00
+10
+08:48 1 client1
+09:41 1 client1
+09:48 1 client2
+09:52 3 client1
+09:54 2 client1 1
+10:25 2 client2 2
+10:58 1 client3
+10:59 2 client3 3
+11:30 1 client4
+11:35 2 client4 2
+11:45 3 client4
+12:33 4 client1
+12:43 4 client2
+)x";
+
+  std::stringstream out;
+  task::RevenuerManager manager(std::string_view(input), out);
+
+  manager.process();
+
+  const auto& stats = manager.runStats();
+
+  EXPECT_GE(stats.iterations, 13);
+  EXPECT_GE(stats.sampled_iterations, 1);
+  EXPECT_GT(stats.finalize_ticks, 0);
+  EXPECT_EQ(stats.input_events, (std::array<std::uint64_t, 4>{5, 4, 2, 2}));
+  EXPECT_EQ(stats.generated_events, (std::array<std::uint64_t, 3>{2, 1, 3}));
+  EXPECT_EQ(stats.errors, (std::array<std::uint64_t, 5>{1, 0, 0, 1, 1}));
+  // The clients leaving at closing time are not queued as pending events.
+  EXPECT_EQ(stats.peak_pending_events, 1);
+  EXPECT_EQ(stats.peak_wait_queue, 1);
+  EXPECT_EQ(stats.peak_clients, 4);
+
+  std::stringstream json;
+
+  manager.writeRunStats(json);
+
+  auto text = json.str();
+
+  EXPECT_NE(
+      text.find(R"("errors": {"NotOpenYet": 1, "YouShallNotPass": 0)"), std::string::npos
+  );
+  EXPECT_NE(text.find(R"("distinct_clients": 4)"), std::string::npos);
+}
+
+TEST(Stats, CountsPipelinedEvents)
+{
+  if constexpr (!task::STATS_ENABLED) {
+    GTEST_SKIP() << "Built without ENABLE_STATS";
+  }
+
+  std::string input = R"x(2
+09:00 19:00
+10
+09:41 1 client1
+09:48 1 client2
+09:52 2 client1 1
+10:25 2 client2 2
+12:33 4 client1
+)x";
+
+  std::stringstream out;
+  task::RevenuerManagerOptions options;
+
+  options.pipelined = true;
+
+  task::RevenuerManager manager(std::string_view(input), out, options);
+
+  manager.process();
+
+  const auto& stats = manager.runStats();
+
+  EXPECT_GE(stats.iterations, 5);
+  EXPECT_GE(stats.sampled_iterations, 1);
+  EXPECT_EQ(stats.input_events, (std::array<std::uint64_t, 4>{2, 2, 0, 1}));
+  EXPECT_EQ(stats.generated_events, (std::array<std::uint64_t, 3>{1, 0, 0}));
+}
+
+TEST(Log, RecordsOfEveryThreadInOrder)
+{
+  std::stringstream out;
+  constexpr int THREAD_COUNT = 4;
+  constexpr int RECORD_COUNT = 2000;
+
+  std::vector<std::thread> threads;
+
+  for (int thread = 0; thread < THREAD_COUNT; ++thread) {
+    threads.emplace_back([&out, thread] {
+      for (int i = 0; i < RECORD_COUNT; ++i) {
+        LOG_ERROR(out) << thread << ' ' << i;
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  task::flushLog();
+
+  std::array<int, THREAD_COUNT> next{};
+  int line_count = 0;
+
+  for (std::string line; std::getline(out, line); ++line_count) {
+    int thread = 0;
+    int i = 0;
+
+    ASSERT_EQ(std::sscanf(line.c_str(), "  [ERROR] %d %d", &thread, &i), 2) << line;
+    EXPECT_EQ(i, next[thread]++);
+  }
+  EXPECT_EQ(line_count, THREAD_COUNT * RECORD_COUNT);
+}
+
+TEST(Log, LevelAndOverflow)
+{
+  std::stringstream out;
+
+  task::setLogLevel(task::LogLevel::WARNING);
+  LOG_INFO(out) << "hidden";
+  LOG_WARNING(out) << "shown " << (LOG_ERROR(out) << "nested", 1);
+  task::setLogLevel(task::LogLevel::DEBUG);
+  task::flushLog();
+
+  EXPECT_EQ(out.str(), "  [ERROR] nested\n[WARNING] shown 1\n");
+
+  // Whatever is not written is counted as dropped. Only records to the standard
+  // streams are left to the log thread, so std::clog is pointed at the buffer.
+  std::stringstream flood;
+  auto* clog_buffer = std::clog.rdbuf(flood.rdbuf());
+  auto dropped = task::droppedLogRecords();
+
+  task::setLogOverflow(task::LogOverflow::DROP);
+
+  for (int i = 0; i < 10'000; ++i) {
+    LOG_ERROR(std::clog) << i;
+  }
+  task::setLogOverflow(task::LogOverflow::BLOCK);
+  task::flushLog();
+  std::clog.rdbuf(clog_buffer);
+
+  auto text = flood.str();
+  auto written = std::count(text.begin(), text.end(), '\n');
+
+  EXPECT_EQ(written + (task::droppedLogRecords() - dropped), 10'000);
+}
+
+TEST(Log, OtherStreamsWrittenBeforeStatementEnds)
+{
+  std::string text;
+
+  {
+    std::ostringstream local;
+
+    LOG_ERROR(local) << "local";
+    text = local.str();
+  }
+
+  EXPECT_EQ(text, "  [ERROR] local\n");
+}
+
+TEST(Log, CharactersAsCharacters)
+{
+  std::ostringstream out;
+
+  LOG_ERROR(out) << 'a' << static_cast<signed char>('b') << static_cast<unsigned char>('c')
+                 << ' ' << static_cast<short>(7) << ' ' << 8u << ' ' << true;
+
+  EXPECT_EQ(out.str(), "  [ERROR] abc 7 8 1\n");
+}
+
+TEST(Format, Clock)
+{
+  std::string out;
+
+  task::appendClock(out, 0);
+  out += ' ';
+  task::appendClock(out, 23 * 60 + 59);
+  out += ' ';
+  task::appendClock(out, 24 * 60 + 7);
+  out += ' ';
+  task::appendClock(out, 125 * 60);
+  out += ' ';
+  task::appendNumber(out, 4294967295u);
+
+  EXPECT_EQ(out, "00:00 23:59 24:07 125:00 4294967295");
+}
+
+TEST(Allocations, NoneInSteadyState)
+{
+  struct NullBuffer : std::streambuf {
+    std::streamsize xsputn(const char*, std::streamsize count) override
+    {
+      return count;
+    }
+
+    int_type overflow(int_type value) override
+    {
+      return traits_type::not_eof(value);
+    }
+  };
+
+  // Every round seats, queues, hands over a table and rejects events, so all the
+  // generated event kinds go through the manager.
+  auto make_log = [](int rounds) {
+    std::string log = "2\n09:00 21:00\n10\n";
+
+    for (int round = 0; round < rounds; ++round) {
+      auto time = 540 + round * 700 / rounds;
+      char clock[16];
+
+      std::snprintf(clock, sizeof(clock), "%02d:%02d ", time / 60, time % 60);
+
+      for (auto line :
+           {"1 a", "1 b", "1 c", "2 a 1", "2 b 2", "3 c", "1 a", "2 c 1", "4 ghost",
+            "4 a", "3 b", "4 b", "4 c"})
+      {
+        log += clock;
+        log += line;
+        log += '\n';
+      }
+    }
+    return log;
+  };
+
+  auto count_allocations = [](const std::string& log) {
+    NullBuffer buffer;
+    std::ostream out(&buffer);
+    auto before = allocation_count.load();
+
+    // Both logs overflow the stream buffer, which then keeps its grown capacity.
+    task::RevenuerManager manager(
+        std::string_view(log), out,
+        task::RevenuerManagerOptions{.streaming = true, .stream_buffer_size = 1024}
+    );
+
+    EXPECT_TRUE(manager.tryProcess());
+
+    return allocation_count.load() - before;
+  };
+
+  auto small = make_log(100);
+  auto large = make_log(1000);
+
+  EXPECT_EQ(count_allocations(small), count_allocations(large));
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);